@@ -0,0 +1,103 @@
+#include "ConcurrentBoneyard.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+template<int MaxPip>
+BasicConcurrentBoneyard<MaxPip>::BasicConcurrentBoneyard(int repeat)
+        : repeat(static_cast<std::uint32_t>(std::max(repeat, 0))) {
+    for (Slot& slot : slots) {
+        slot.state.store(this->repeat, std::memory_order_release);
+    }
+}
+
+template<int MaxPip>
+bool BasicConcurrentBoneyard<MaxPip>::claim(size_t index) noexcept {
+    std::atomic<std::uint64_t>& state = slots[index].state;
+    std::uint64_t current = state.load(std::memory_order_relaxed);
+    while (copiesOf(current) > 0) {
+        if (state.compare_exchange_weak(current, current + VERSION_STEP - 1, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<int MaxPip>
+size_t BasicConcurrentBoneyard<MaxPip>::snapshot(Snapshot& states) const noexcept {
+    for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+        states[index] = slots[index].state.load(std::memory_order_acquire);
+    }
+    // Повтор нужен, только если между чтениями какая-то кость изменилась
+    for (bool stable = false; !stable;) {
+        stable = true;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            std::uint64_t current = slots[index].state.load(std::memory_order_acquire);
+            stable &= current == states[index];
+            states[index] = current;
+        }
+    }
+
+    size_t total = 0;
+    for (std::uint64_t current : states) {
+        total += copiesOf(current);
+    }
+    return total;
+}
+
+template<int MaxPip>
+std::optional<BasicDomino<MaxPip>> BasicConcurrentBoneyard<MaxPip>::draw() {
+    return draw(DominoRng::threadLocal());
+}
+
+template<int MaxPip>
+std::optional<BasicDomino<MaxPip>> BasicConcurrentBoneyard<MaxPip>::tryDraw(int left, int right) {
+    if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) {
+        throw std::invalid_argument("Values should be between 0 and " + std::to_string(MaxPip));
+    }
+    Tile requested(static_cast<std::uint8_t>(left), static_cast<std::uint8_t>(right));
+    size_t index = Tables::canonicalIndex[requested.code()];
+    if (!claim(index)) return std::nullopt;
+    return requested;
+}
+
+template<int MaxPip>
+void BasicConcurrentBoneyard<MaxPip>::returnTile(const Tile& domino) {
+    std::atomic<std::uint64_t>& state = slots[Tables::canonicalIndex[domino.code()]].state;
+    std::uint64_t current = state.load(std::memory_order_relaxed);
+    do {
+        if (copiesOf(current) >= repeat) {
+            throw std::invalid_argument("Boneyard already holds every copy of this domino");
+        }
+    } while (!state.compare_exchange_weak(current, current + VERSION_STEP + 1, std::memory_order_acq_rel));
+}
+
+template<int MaxPip>
+size_t BasicConcurrentBoneyard<MaxPip>::size() const noexcept {
+    Snapshot states;
+    return snapshot(states);
+}
+
+template<int MaxPip>
+size_t BasicConcurrentBoneyard<MaxPip>::count(int left, int right) const noexcept {
+    if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) return 0;
+    return copiesOf(slots[Tables::canonical(left, right)].state.load(std::memory_order_acquire));
+}
+
+template<int MaxPip>
+BasicDominoGroup<MaxPip> BasicConcurrentBoneyard<MaxPip>::toGroup() const {
+    Snapshot states;
+    BasicDominoGroup<MaxPip> group;
+    group.reserve(snapshot(states));
+    for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+        for (std::uint32_t k = 0; k < copiesOf(states[index]); k++) {
+            group += Tables::fullSet[index];
+        }
+    }
+    return group;
+}
+
+template class BasicConcurrentBoneyard<6>;
+template class BasicConcurrentBoneyard<9>;
+template class BasicConcurrentBoneyard<12>;
+template class BasicConcurrentBoneyard<15>;
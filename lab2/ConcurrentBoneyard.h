@@ -0,0 +1,184 @@
+#ifndef CONCURRENTBONEYARD_H
+#define CONCURRENTBONEYARD_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include "Domino.h"
+#include "DominoGroup.h"
+#include "DominoRandom.h"
+#include "DominoTables.h"
+
+/**
+ * @class BasicConcurrentBoneyard
+ * @brief Общий базар, из которого много потоков одновременно берут и возвращают домино без блокировок.
+ *
+ * Базар строится как generateFullSet(repeat) и хранится по костям: у каждой кости свое атомарное
+ * состояние (количество и номер версии) на отдельной линии кэша. Взятие и возврат меняют только
+ * состояние выбранной кости, общего счетчика нет, поэтому потоки, работающие с разными костями,
+ * не конкурируют за одну линию кэша.
+ *
+ * Все операции неблокирующие (lock-free) и линеаризуемые. Взятие и возврат линеаризуются в
+ * момент успешного CAS на состоянии кости; повтор CAS нужен, только если другой поток успел
+ * изменить это состояние, то есть продвинулся. Пустое значение draw, size() и toGroup()
+ * опираются на снимок: состояния всех костей читаются дважды подряд, пока оба чтения не
+ * совпадут. Каждое изменение увеличивает версию кости, поэтому совпавшие чтения означают, что
+ * между ними базар содержал ровно эти домино; в этот момент операция и линеаризуется.
+ *
+ * Случайная кость выбирается выборкой с отклонением: равномерно выбирается один из
+ * TILE_COUNT * repeat экземпляров и принимается, если он еще в базаре. Если за SAMPLE_ATTEMPTS
+ * попыток ничего не найдено (базар почти пуст), домино выбирается по снимку пропорционально
+ * количеству каждой кости. В обоих случаях каждое оставшееся домино вытягивается с одинаковой
+ * вероятностью.
+ * Для набора 0..6 доступно имя ConcurrentBoneyard.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+class BasicConcurrentBoneyard {
+public:
+    using Tile = BasicDomino<MaxPip>;         /**< Тип домино базара. */
+    using Tables = BasicDominoTables<MaxPip>; /**< Таблицы набора. */
+
+    static constexpr size_t CACHE_LINE = 64;     /**< Размер линии кэша, по которому выравниваются счетчики. */
+    static constexpr size_t SAMPLE_ATTEMPTS = 4 * Tables::TILE_COUNT; /**< Попыток случайной выборки до выбора по снимку. */
+
+private:
+    /** @brief Снимок состояний всех костей. */
+    using Snapshot = std::array<std::uint64_t, Tables::TILE_COUNT>;
+
+    static constexpr std::uint64_t VERSION_STEP = std::uint64_t{1} << 32; /**< Шаг версии в старших битах состояния. */
+
+    /**
+     * @brief Состояние одной кости на отдельной линии кэша.
+     *
+     * Младшие 32 бита — количество экземпляров, старшие — версия, которая растет при каждом изменении.
+     */
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<std::uint64_t> state{0};
+    };
+
+    std::array<Slot, Tables::TILE_COUNT> slots; /**< Состояния костей в каноническом порядке. */
+    std::uint32_t repeat; /**< Количество экземпляров каждой кости в полном базаре. */
+
+    /**
+     * @brief Извлекает количество экземпляров из состояния кости.
+     * @param state Состояние кости.
+     * @return Количество экземпляров.
+     */
+    static std::uint32_t copiesOf(std::uint64_t state) noexcept {
+        return static_cast<std::uint32_t>(state);
+    }
+
+    /**
+     * @brief Забирает один экземпляр кости, если он есть.
+     * @param index Канонический номер кости.
+     * @return true, если экземпляр забран.
+     */
+    bool claim(size_t index) noexcept;
+
+    /**
+     * @brief Делает согласованный снимок состояний всех костей (двойное чтение).
+     * @param states Снимок.
+     * @return Количество домино в снимке.
+     */
+    size_t snapshot(Snapshot& states) const noexcept;
+
+public:
+    /**
+     * @brief Создает базар из полного набора, в котором каждая кость повторяется repeat раз.
+     * @param repeat Количество экземпляров каждой кости (при repeat <= 0 базар пуст).
+     */
+    explicit BasicConcurrentBoneyard(int repeat = 1);
+
+    BasicConcurrentBoneyard(const BasicConcurrentBoneyard&) = delete;
+    BasicConcurrentBoneyard& operator=(const BasicConcurrentBoneyard&) = delete;
+
+    /**
+     * @brief Берет случайное домино, используя генератор текущего потока.
+     * @return Домино в канонической ориентации или пустое значение, если базар пуст.
+     */
+    std::optional<Tile> draw();
+
+    /**
+     * @brief Берет случайное домино, используя заданный генератор.
+     * @tparam Generator Тип, удовлетворяющий UniformRandomBitGenerator.
+     * @param gen Генератор случайных чисел (свой у каждого потока).
+     * @return Домино в канонической ориентации или пустое значение, если базар пуст.
+     */
+    template<typename Generator>
+    std::optional<Tile> draw(Generator& gen) {
+        if (repeat == 0) return std::nullopt;
+
+        const std::uint64_t copies = static_cast<std::uint64_t>(Tables::TILE_COUNT) * repeat;
+        for (size_t attempt = 0; attempt < SAMPLE_ATTEMPTS; attempt++) {
+            std::uint64_t copy = DominoRng::bounded(gen, copies);
+            size_t index = static_cast<size_t>(copy / repeat);
+            if (copy % repeat >= copiesOf(slots[index].state.load(std::memory_order_relaxed))) continue;
+            if (claim(index)) return Tables::fullSet[index];
+        }
+
+        // Почти пустой базар: выбор по снимку, неудачный claim значит, что базар изменился
+        Snapshot states;
+        while (size_t total = snapshot(states)) {
+            std::uint64_t copy = DominoRng::bounded(gen, total);
+            size_t index = 0;
+            while (copy >= copiesOf(states[index])) {
+                copy -= copiesOf(states[index++]);
+            }
+            if (claim(index)) return Tables::fullSet[index];
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Берет конкретное домино, если оно есть в базаре.
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Домино в запрошенной ориентации или пустое значение, если его нет.
+     * @throws std::invalid_argument Если значения вне диапазона 0..MaxPip.
+     */
+    std::optional<Tile> tryDraw(int left, int right);
+
+    /**
+     * @brief Возвращает домино в базар.
+     * @param domino Возвращаемое домино.
+     * @throws std::invalid_argument Если в базаре уже все repeat экземпляров этой кости.
+     */
+    void returnTile(const Tile& domino);
+
+    /**
+     * @brief Возвращает количество домино в базаре.
+     *
+     * Количество берется из согласованного снимка, поэтому оно было точным в некоторый момент
+     * во время вызова.
+     * @return Количество домино, доступных для взятия.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Возвращает количество экземпляров указанного домино в базаре.
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Количество экземпляров; 0 для значений вне диапазона.
+     */
+    size_t count(int left, int right) const noexcept;
+
+    /**
+     * @brief Копирует содержимое базара в обычную группу в каноническом порядке.
+     *
+     * Копия строится по согласованному снимку, поэтому совпадает с содержимым базара в некоторый
+     * момент во время вызова.
+     * @return Группа с домино базара.
+     */
+    BasicDominoGroup<MaxPip> toGroup() const;
+};
+
+extern template class BasicConcurrentBoneyard<6>;
+extern template class BasicConcurrentBoneyard<9>;
+extern template class BasicConcurrentBoneyard<12>;
+extern template class BasicConcurrentBoneyard<15>;
+
+using ConcurrentBoneyard = BasicConcurrentBoneyard<6>; /**< Общий базар классических домино 0..6. */
+
+#endif
@@ -1,132 +1,111 @@
 #include "Domino.h"
 #include <iostream>
 #include <stdexcept>
+#include <cstring>
 
 using std::cin;
 using std::cout;
 using std::endl;
 using std::uint8_t;
 
-Domino::Domino(uint8_t l, uint8_t r) : left(l), right(r) {
-    if (l < 0 || l > 6 || r < 0 || r > 6) {
-        throw std::invalid_argument("Values should be between 0 and 6");
-    }
+template<int MaxPip>
+BasicDomino<MaxPip> BasicDomino<MaxPip>::generateRandomDomino() {
+    return generateRandomDomino(DominoRng::threadLocal());
 }
 
-Domino Domino::generateRandomDomino() {
-    static std::mt19937 gen(static_cast<unsigned>(std::time(nullptr))); /**< Инициализация генератора времени */
-    static std::uniform_int_distribution<> dist(0, 6); /**< Интервал от 0 до 6 */
-    return {static_cast<uint8_t>(dist(gen)), static_cast<uint8_t>(dist(gen))};
+namespace {
+    /**
+     * @brief Строки изображения половины домино для значений 0..15.
+     *
+     * До 9 точек помещаются в сетку 3x3, большие значения рисуются числом в средней строке.
+     */
+    constexpr char GLYPHS[16][3][6] = {
+            {"     ", "     ", "     "},
+            {"     ", "  o  ", "     "},
+            {"  o  ", "     ", "  o  "},
+            {"o    ", "  o  ", "    o"},
+            {"o   o", "     ", "o   o"},
+            {"o   o", "  o  ", "o   o"},
+            {"o   o", "o   o", "o   o"},
+            {"o   o", "o o o", "o   o"},
+            {"o o o", "o   o", "o o o"},
+            {"o o o", "o o o", "o o o"},
+            {"     ", " 10  ", "     "},
+            {"     ", " 11  ", "     "},
+            {"     ", " 12  ", "     "},
+            {"     ", " 13  ", "     "},
+            {"     ", " 14  ", "     "},
+            {"     ", " 15  ", "     "},
+    };
 }
 
-uint8_t Domino::getLeft() const {
-    return left;
+template<int MaxPip>
+void BasicDomino<MaxPip>::print(std::ostream& out) const {
+    char buffer[PICTURE_HEIGHT * (PICTURE_WIDTH + 1) + 1];
+    char* end = renderRow(buffer, this, 1);
+    out.write(buffer, end - buffer);
 }
 
-uint8_t Domino::getRight() const {
-    return right;
+template<int MaxPip>
+size_t BasicDomino<MaxPip>::renderedRowSize(size_t n) {
+    if (n == 0) return 0;
+    return PICTURE_HEIGHT * (n * (PICTURE_WIDTH + 1)) + 1;
 }
 
-void Domino::setLeft(uint8_t l) {
-    if (l < 0 || l > 6) {
-        throw std::invalid_argument("Left value should be between 0 and 6");
+template<int MaxPip>
+char* BasicDomino<MaxPip>::renderRow(char* out, const BasicDomino* tiles, size_t n) {
+    if (n == 0) return out;
+    for (size_t line = 0; line < PICTURE_HEIGHT; line++) {
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0) *out++ = ' ';
+            if (line == 3) {
+                std::memcpy(out, "|-------|", PICTURE_WIDTH);
+            } else {
+                std::uint8_t value = line < 3 ? tiles[i].left : tiles[i].right;
+                if (value > MaxPip) throw std::runtime_error("Error");
+                out[0] = '|';
+                out[1] = ' ';
+                std::memcpy(out + 2, GLYPHS[value][line < 3 ? line : line - 4], 5);
+                out[7] = ' ';
+                out[8] = '|';
+            }
+            out += PICTURE_WIDTH;
+        }
+        *out++ = '\n';
     }
-    left = l;
-}
-
-void Domino::setRight(uint8_t r) {
-    if (r < 0 || r > 6) {
-        throw std::invalid_argument("Right value should be between 0 and 6");
-    }
-    right = r;
-}
-
-Domino Domino::operator~() const {
-    return {right, left};
-}
-
-bool Domino::operator==(const Domino &domino) const {
-    return (left == domino.left && right == domino.right) || (left == domino.right && right == domino.left);
-}
-
-void Domino::print() const {
-    printHalf(left);
-    cout << "|-------|" << endl;
-    printHalf(right);
-    cout << endl;
-}
-
-Domino& Domino::operator=(const Domino& other) {
-    if (this != &other) {
-        left = other.left;
-        right = other.right;
-    }
-    return *this;
+    *out++ = '\n';
+    return out;
 }
 
-std::istream& operator>>(std::istream& in, Domino& d) {
+template<int MaxPip>
+std::istream& operator>>(std::istream& in, BasicDomino<MaxPip>& d) {
     int left, right;
-    in >> left >> right;
-    if (left < 0 || left > 6 || right < 0 || right > 6) {
-        throw std::invalid_argument("Values should be between 0 and 6");
+    if (!(in >> left >> right)) return in;
+    if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) {
+        BasicDomino<MaxPip>::throwOutOfRange("Values");
     }
     d.setLeft(static_cast<uint8_t>(left));
     d.setRight(static_cast<uint8_t>(right));
     return in;
 }
 
-std::ostream& operator<<(std::ostream& out, const Domino& d) {
+template<int MaxPip>
+std::ostream& operator<<(std::ostream& out, const BasicDomino<MaxPip>& d) {
     out << "(" << static_cast<int>(d.getLeft()) << "|" << static_cast<int>(d.getRight()) << ")";
     return out;
 }
 
-void Domino::printHalf(uint8_t value) {
-    cout << "| ";
-    printLine(value, 1);
-    cout << " |" << endl;
-
-    cout << "| ";
-    printLine(value, 2);
-    cout << " |" << endl;
+template class BasicDomino<6>;
+template class BasicDomino<9>;
+template class BasicDomino<12>;
+template class BasicDomino<15>;
 
-    cout << "| ";
-    printLine(value, 3);
-    cout << " |" << endl;
-}
-
-void Domino::printLine(uint8_t value, int line) {
-    switch (value) {
-        case 0:
-            cout << "     ";
-            break;
-        case 1:
-            if (line == 2) cout << "  o  ";
-            else cout << "     ";
-            break;
-        case 2:
-            if (line == 1) cout << "  o  ";
-            else if (line == 3) cout << "  o  ";
-            else cout << "     ";
-            break;
-        case 3:
-            if (line == 1) cout << "o    ";
-            else if (line == 2) cout << "  o  ";
-            else cout << "    o";
-            break;
-        case 4:
-            if (line == 1 || line == 3) cout << "o   o";
-            else std::cout << "     ";
-            break;
-        case 5:
-            if (line == 1) cout << "o   o";
-            else if (line == 2) cout << "  o  ";
-            else cout << "o   o";
-            break;
-        case 6:
-            cout << "o   o";
-            break;
-        default:
-            throw std::runtime_error("Error");
-    }
-}
+template std::istream& operator>>(std::istream&, BasicDomino<6>&);
+template std::istream& operator>>(std::istream&, BasicDomino<9>&);
+template std::istream& operator>>(std::istream&, BasicDomino<12>&);
+template std::istream& operator>>(std::istream&, BasicDomino<15>&);
 
+template std::ostream& operator<<(std::ostream&, const BasicDomino<6>&);
+template std::ostream& operator<<(std::ostream&, const BasicDomino<9>&);
+template std::ostream& operator<<(std::ostream&, const BasicDomino<12>&);
+template std::ostream& operator<<(std::ostream&, const BasicDomino<15>&);
@@ -4,66 +4,213 @@
 #include <iostream>
 #include <stdexcept>
 #include <cstdint>
+#include <functional>
 #include <random>
-#include <ctime>
+#include <limits>
+#include <string>
+#include "DominoRandom.h"
+
+/**
+ * @brief Канонический номер домино по значениям сторон, без проверки диапазона.
+ *
+ * Номер не зависит от ориентации и совпадает с позицией домино в generateFullSet.
+ * @param left Левая сторона (от 0 до pips - 1).
+ * @param right Правая сторона (от 0 до pips - 1).
+ * @param pips Количество различных значений стороны (7 для набора 0..6).
+ * @return Канонический номер.
+ */
+constexpr size_t dominoCanonicalIndex(int left, int right, int pips = 7) noexcept {
+    if (left > right) {
+        int t = left;
+        left = right;
+        right = t;
+    }
+    // Строка left начинается после костей (0|0..max), (1|1..max), ..., (left-1|left-1..max)
+    return static_cast<size_t>(left * pips - left * (left - 1) / 2 + (right - left));
+}
 
 
 /**
- * @class Domino
+ * @class BasicDomino
  * @brief Класс, представляющий домино с двумя сторонами.
  *
- * Класс Domino содержит две стороны с числами от 0 до 6. Обеспечивает методы для
+ * Класс BasicDomino содержит две стороны с числами от 0 до MaxPip. Обеспечивает методы для
  * получения и установки значений, генерации случайных домино, сравнения и переворачивания.
+ * Диапазон значений — параметр шаблона, поэтому проверки и коды вычисляются на этапе компиляции.
+ * Классический набор 0..6 доступен под именем Domino.
+ * @tparam MaxPip Наибольшее значение стороны (6, 9, 12 или 15).
  */
-class Domino {
+template<int MaxPip>
+class BasicDomino {
+    static_assert(MaxPip >= 1 && MaxPip <= 15, "Supported pip ranges are 0..1 to 0..15");
+
 private:
-    std::uint8_t left;  /**< Левая сторона домино. Значение от 0 до 6. */
-    std::uint8_t right; /**< Правая сторона домино. Значение от 0 до 6. */
+    std::uint8_t left;  /**< Левая сторона домино. Значение от 0 до MaxPip. */
+    std::uint8_t right; /**< Правая сторона домино. Значение от 0 до MaxPip. */
+
+    /**
+     * @brief Бросает исключение о значении вне диапазона 0..MaxPip.
+     * @param what Название проверяемого значения.
+     */
+    [[noreturn]] static void throwOutOfRange(const char* what) {
+        throw std::invalid_argument(std::string(what) + " should be between 0 and " + std::to_string(MaxPip));
+    }
 
 public:
+    static constexpr int MAX_PIP = MaxPip;                          /**< Наибольшее значение стороны. */
+    static constexpr unsigned PIPS = MaxPip + 1;                    /**< Количество различных значений стороны. */
+    static constexpr unsigned ORDERED_COUNT = PIPS * PIPS;          /**< Количество упорядоченных пар (left, right). */
+    static constexpr unsigned TILE_COUNT = PIPS * (PIPS + 1) / 2;   /**< Количество различных костей без учета ориентации. */
+
+    /**
+     * @brief Тег для конструктора без проверки значений.
+     */
+    struct Unchecked {};
+    /**
+     * @brief Значение тега для конструктора без проверки значений.
+     */
+    static constexpr Unchecked unchecked{};
+
     /**
      * @brief Конструктор домино с двумя значениями.
-     * @param l Левая сторона (значение от 0 до 6, по умолчанию 0).
-     * @param r Правая сторона (значение от 0 до 6, по умолчанию 0).
-     * @throws std::invalid_argument Если значения не находятся в пределах от 0 до 6.
+     *
+     * Может использоваться в константных выражениях; недопустимые значения в них
+     * приводят к ошибке компиляции.
+     * @param l Левая сторона (значение от 0 до MaxPip, по умолчанию 0).
+     * @param r Правая сторона (значение от 0 до MaxPip, по умолчанию 0).
+     * @throws std::invalid_argument Если значения не находятся в пределах от 0 до MaxPip.
+     */
+    constexpr BasicDomino(std::uint8_t l = 0, std::uint8_t r = 0) : left(l), right(r) {
+        if (l > MaxPip || r > MaxPip) {
+            throwOutOfRange("Values");
+        }
+    }
+
+    /**
+     * @brief Конструктор без проверки значений для уже проверенных данных во внутренних циклах.
+     * @param l Левая сторона (вызывающий гарантирует значение от 0 до MaxPip).
+     * @param r Правая сторона (вызывающий гарантирует значение от 0 до MaxPip).
+     */
+    constexpr BasicDomino(Unchecked, std::uint8_t l, std::uint8_t r) noexcept : left(l), right(r) {}
+
+    /**
+     * @brief Создает домино по упорядоченному коду left * PIPS + right без проверки.
+     * @param code Код от 0 до ORDERED_COUNT - 1.
+     * @return Домино с соответствующими сторонами.
+     */
+    static constexpr BasicDomino fromCode(unsigned code) noexcept {
+        return {unchecked, static_cast<std::uint8_t>(code / PIPS), static_cast<std::uint8_t>(code % PIPS)};
+    }
+
+    /**
+     * @brief Возвращает упорядоченный код домино left * PIPS + right (0..ORDERED_COUNT - 1),
+     * учитывающий ориентацию.
+     * @return Код домино.
      */
-    Domino(std::uint8_t l = 0, std::uint8_t r = 0);
+    constexpr unsigned code() const noexcept {
+        return left * PIPS + right;
+    }
+
+    /**
+     * @brief Возвращает канонический код домино (0..TILE_COUNT - 1), не зависящий от ориентации.
+     *
+     * Домино, равные по operator==, имеют один и тот же код; он совпадает с позицией домино
+     * в generateFullSet. Для набора 0..6 это номер от 0 до 27.
+     * @return Канонический код.
+     */
+    constexpr unsigned canonicalCode() const noexcept {
+        return static_cast<unsigned>(dominoCanonicalIndex(left, right, PIPS));
+    }
+
+    /**
+     * @brief Создает домино по каноническому коду без проверки, в ориентации left <= right.
+     * @param index Канонический код от 0 до TILE_COUNT - 1.
+     * @return Домино с этим кодом.
+     */
+    static constexpr BasicDomino fromCanonicalCode(unsigned index) noexcept {
+        unsigned l = 0;
+        // Строка l содержит кости (l|l), (l|l + 1), ..., (l|MaxPip)
+        while (index >= PIPS - l) {
+            index -= PIPS - l;
+            ++l;
+        }
+        return {unchecked, static_cast<std::uint8_t>(l), static_cast<std::uint8_t>(l + index)};
+    }
 
     /**
      * @brief Генерирует случайный объект домино.
+     *
+     * Использует генератор текущего потока (DominoRng::threadLocal), поэтому безопасен
+     * при вызове из нескольких потоков.
+     * @return Случайно сгенерированный объект домино.
+     */
+    static BasicDomino generateRandomDomino();
+
+    /**
+     * @brief Генерирует случайный объект домино с помощью заданного генератора.
+     *
+     * Для 64-битных генераторов (например, DominoRng) делается один вызов на домино:
+     * результат отображается сразу в один из ORDERED_COUNT упорядоченных исходов.
+     * @tparam Generator Тип, удовлетворяющий UniformRandomBitGenerator.
+     * @param gen Генератор случайных чисел.
      * @return Случайно сгенерированный объект домино.
      */
-    static Domino generateRandomDomino();
+    template<typename Generator>
+    static BasicDomino generateRandomDomino(Generator& gen) {
+        unsigned code;
+        if constexpr (Generator::min() == 0 && Generator::max() == std::numeric_limits<std::uint64_t>::max()) {
+            code = static_cast<unsigned>(DominoRng::scale(gen(), ORDERED_COUNT));
+        } else {
+            code = std::uniform_int_distribution<unsigned>(0, ORDERED_COUNT - 1)(gen);
+        }
+        return fromCode(code);
+    }
 
     /**
      * @brief Получает значение левой стороны домино.
      * @return Значение левой стороны.
      */
-    std::uint8_t getLeft() const;
+    constexpr std::uint8_t getLeft() const noexcept {
+        return left;
+    }
     /**
      * @brief Получает значение правой стороны домино.
      * @return Значение правой стороны.
      */
-    std::uint8_t getRight() const;
+    constexpr std::uint8_t getRight() const noexcept {
+        return right;
+    }
 
     /**
      * @brief Устанавливает значение левой стороны домино.
      * @param l Новое значение для левой стороны.
-     * @throws std::invalid_argument Если значение не находится в пределах от 0 до 6.
+     * @throws std::invalid_argument Если значение не находится в пределах от 0 до MaxPip.
      */
-    void setLeft(std::uint8_t l);
+    constexpr void setLeft(std::uint8_t l) {
+        if (l > MaxPip) {
+            throwOutOfRange("Left value");
+        }
+        left = l;
+    }
     /**
      * @brief Устанавливает значение левой стороны домино.
      * @param r Новое значение для правой стороны.
-     * @throws std::invalid_argument Если значение не находится в пределах от 0 до 6.
+     * @throws std::invalid_argument Если значение не находится в пределах от 0 до MaxPip.
      */
-    void setRight(std::uint8_t r);
+    constexpr void setRight(std::uint8_t r) {
+        if (r > MaxPip) {
+            throwOutOfRange("Right value");
+        }
+        right = r;
+    }
 
     /**
      * @brief Переворачивает домино, меняя левую и правую стороны местами.
      * @return Новый объект домино с перевернутыми сторонами.
      */
-    Domino operator~() const;
+    constexpr BasicDomino operator~() const noexcept {
+        return {unchecked, right, left};
+    }
 
     /**
      * @brief Сравнивает два домино.
@@ -71,14 +218,19 @@ public:
      * @return true, если домино равны (не имеет значения, на какой стороне какое число).
      * @return false, если домино не равны.
      */
-    bool operator==(const Domino &domino) const;
+    constexpr bool operator==(const BasicDomino &domino) const noexcept {
+        return (left == domino.left && right == domino.right) || (left == domino.right && right == domino.left);
+    }
 
     /**
      * @brief Оператор присваивания для домино.
+     *
+     * Реализован по умолчанию, поэтому домино остается тривиально копируемым (2 байта),
+     * и группы могут копировать домино через memcpy.
      * @param other Объект домино для копирования.
      * @return Ссылка на текущий объект после присваивания.
      */
-    Domino& operator=(const Domino& other);
+    BasicDomino& operator=(const BasicDomino& other) = default;
 
     /**
      * @brief Перегруженный оператор ввода для домино.
@@ -86,7 +238,8 @@ public:
      * @param d Объект домино для заполнения.
      * @return Входной поток.
      */
-    friend std::istream& operator>>(std::istream& in, Domino& d);
+    template<int P>
+    friend std::istream& operator>>(std::istream& in, BasicDomino<P>& d);
 
     /**
      * @brief Перегруженный оператор вывода для домино.
@@ -94,26 +247,69 @@ public:
      * @param d Объект домино для вывода.
      * @return Выходной поток.
      */
-    friend std::ostream& operator<<(std::ostream& out, const Domino& d);
+    template<int P>
+    friend std::ostream& operator<<(std::ostream& out, const BasicDomino<P>& d);
 
     /**
-     * @brief Выводит изображение домино на консоль.
+     * @brief Ширина изображения одного домино в символах.
      */
-    void print() const;
+    static constexpr size_t PICTURE_WIDTH = 9;
+    /**
+     * @brief Высота изображения одного домино в строках.
+     */
+    static constexpr size_t PICTURE_HEIGHT = 7;
 
-private:
     /**
-     * @brief Выводит одну сторону домино.
-     * @param value Значение стороны (от 0 до 6).
+     * @brief Выводит изображение домино в поток одной записью.
+     * @param out Выходной поток (по умолчанию консоль).
      */
-    static void printHalf(std::uint8_t value);
+    void print(std::ostream& out = std::cout) const;
 
     /**
-     * @brief Выводит одну строку изображения домино для заданного значения.
-     * @param value Значение стороны (от 0 до 6).
-     * @param line Номер строки для вывода (1, 2 или 3).
+     * @brief Возвращает размер в байтах изображения ряда из n домино, нарисованных рядом.
+     * @param n Количество домино в ряду.
+     * @return Количество байт, включая переводы строк и пустую строку после ряда.
      */
-    static void printLine(std::uint8_t value, int line);
+    static size_t renderedRowSize(size_t n);
+
+    /**
+     * @brief Рисует ряд домино, расположенных рядом, в буфер вызывающей стороны.
+     *
+     * Изображение строится из заранее подготовленной таблицы глифов: значения до 9 рисуются
+     * точками в сетке 3x3, большие — числом. Ряд из одного домино совпадает побайтно с выводом print().
+     * @param out Начало буфера, в нем должно быть не меньше renderedRowSize(n) байт.
+     * @param tiles Указатель на первое домино ряда.
+     * @param n Количество домино в ряду.
+     * @return Указатель на байт, следующий за последним записанным.
+     */
+    static char* renderRow(char* out, const BasicDomino* tiles, size_t n);
+};
+
+template<int MaxPip>
+std::istream& operator>>(std::istream& in, BasicDomino<MaxPip>& d);
+
+template<int MaxPip>
+std::ostream& operator<<(std::ostream& out, const BasicDomino<MaxPip>& d);
+
+extern template class BasicDomino<6>;
+extern template class BasicDomino<9>;
+extern template class BasicDomino<12>;
+extern template class BasicDomino<15>;
+
+using Domino = BasicDomino<6>;    /**< Классическое домино 0..6 (28 костей). */
+using Domino9 = BasicDomino<9>;   /**< Домино 0..9 (55 костей). */
+using Domino12 = BasicDomino<12>; /**< Домино 0..12 (91 кость). */
+using Domino15 = BasicDomino<15>; /**< Домино 0..15 (136 костей). */
+
+/**
+ * @brief Хеш домино по каноническому коду: (a|b) и (b|a) равны по operator== и имеют один хеш.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+struct std::hash<BasicDomino<MaxPip>> {
+    size_t operator()(const BasicDomino<MaxPip>& domino) const noexcept {
+        return domino.canonicalCode();
+    }
 };
 
 #endif
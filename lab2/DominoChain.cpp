@@ -0,0 +1,226 @@
+#include "DominoChain.h"
+#include "DominoTables.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    constexpr int PIPS = DominoTables::PIPS;
+    constexpr size_t TILES = DominoTables::TILE_COUNT;
+
+    /**
+     * @brief Состояние поиска цепочки для одной группы.
+     *
+     * Если домино какого-то вида k >= 2 штук, то в оптимальной цепочке их используется 0, k - 1
+     * или k (пару одинаковых домино всегда можно добавить, пройдя ребро туда и обратно).
+     * Поэтому количество сокращается до 2 или 3 с той же четностью, а остаток (bonus)
+     * добавляется при первом использовании вида. Тогда количество каждого вида помещается
+     * в 2 бита, и состояние вместе с вершиной кодируется одним 64-битным ключом.
+     */
+    class ChainSearch {
+    private:
+        std::array<int, PIPS * PIPS> tileOf{};   /**< Канонический номер домино для пары вершин. */
+        std::array<std::uint8_t, TILES> initial{}; /**< Сокращенное исходное количество каждого вида. */
+        std::array<std::uint8_t, TILES> left{};    /**< Сокращенное оставшееся количество каждого вида. */
+        std::array<size_t, TILES> bonus{};         /**< Сколько домино вида отброшено при сокращении. */
+        /**
+         * @brief Запомненный результат extend: точное значение или верхняя оценка.
+         */
+        struct Entry {
+            size_t value;
+            bool exact;
+        };
+        std::unordered_map<std::uint64_t, Entry> memo; /**< Лучшее продолжение для состояния. */
+
+        std::uint64_t key(int v) const {
+            std::uint64_t k = static_cast<std::uint64_t>(v);
+            for (size_t t = 0; t < TILES; t++) {
+                k |= static_cast<std::uint64_t>(left[t]) << (3 + 2 * t);
+            }
+            return k;
+        }
+
+        size_t gain(size_t t) const {
+            return 1 + (left[t] == initial[t] ? bonus[t] : 0);
+        }
+
+        /**
+         * @brief Оценивает сверху длину цепочки из вершины v по компоненте оставшихся домино.
+         *
+         * Цепочка из v может иметь нечетную степень только в v и в конце, а каждое неиспользованное
+         * домино меняет четность не более чем двух вершин. Поэтому из компоненты с odd нечетными
+         * вершинами придется не использовать хотя бы (odd - 2) / 2 домино, если v нечетна,
+         * и odd / 2 — если четна. Оценка точна, когда все домино компоненты проходятся эйлеровым путем.
+         * @param v Текущая вершина.
+         * @param exact Устанавливается в true, если оценка заведомо достигается.
+         * @return Верхняя оценка числа домино в цепочке.
+         */
+        size_t upperBound(int v, bool& exact) const {
+            bool seen[PIPS] = {};
+            int stack[PIPS];
+            int top = 0;
+            stack[top++] = v;
+            seen[v] = true;
+            size_t weight = 0;
+            int odd = 0;
+            bool startOdd = false;
+            while (top > 0) {
+                int u = stack[--top];
+                size_t degree = 0;
+                for (int w = 0; w < PIPS; w++) {
+                    size_t t = tileOf[u * PIPS + w];
+                    if (left[t] == 0) continue;
+                    if (w != u) degree += left[t];
+                    if (w >= u) weight += left[t] + (left[t] == initial[t] ? bonus[t] : 0);
+                    if (!seen[w]) {
+                        seen[w] = true;
+                        stack[top++] = w;
+                    }
+                }
+                if (degree % 2 == 1) {
+                    ++odd;
+                    if (u == v) startOdd = true;
+                }
+            }
+            exact = odd == 0 || (odd == 2 && startOdd);
+            size_t unused = startOdd ? (odd - 2) / 2 : odd / 2;
+            return weight - std::min(weight, unused);
+        }
+
+    public:
+        explicit ChainSearch(const DominoGroup& group) {
+            for (int a = 0; a < PIPS; a++) {
+                for (int b = 0; b < PIPS; b++) {
+                    tileOf[a * PIPS + b] = static_cast<int>(DominoTables::canonical(a, b));
+                }
+            }
+            std::array<size_t, TILES> counts{};
+            for (size_t i = 0; i < group.size(); i++) {
+                const Domino& d = group[static_cast<int>(i)];
+                ++counts[DominoTables::canonicalIndex[d.code()]];
+            }
+            for (size_t t = 0; t < TILES; t++) {
+                initial[t] = static_cast<std::uint8_t>(counts[t] < 2 ? counts[t] : 2 + counts[t] % 2);
+                bonus[t] = counts[t] - initial[t];
+            }
+            left = initial;
+        }
+
+        /**
+         * @brief Максимальное число домино, которое можно выложить, начиная из вершины v.
+         *
+         * Результат точен, если он больше floor; иначе это лишь верхняя оценка, не превышающая floor.
+         * Это позволяет не досчитывать ветви, которые заведомо не лучше уже найденной цепочки.
+         * @param v Текущая вершина.
+         * @param floor Длина, которую нужно превзойти.
+         * @return Длина лучшей цепочки или верхняя оценка.
+         */
+        size_t extend(int v, size_t floor) {
+            bool exact;
+            size_t bound = upperBound(v, exact);
+            if (exact || bound <= floor) return bound;
+
+            std::uint64_t k = key(v);
+            auto it = memo.find(k);
+            if (it != memo.end() && (it->second.exact || it->second.value <= floor)) {
+                return it->second.value;
+            }
+
+            size_t best = 0;
+            for (int w = 0; w < PIPS && best < bound; w++) {
+                size_t t = tileOf[v * PIPS + w];
+                if (left[t] == 0) continue;
+                size_t g = gain(t);
+                size_t need = std::max(floor, best);
+                --left[t];
+                best = std::max(best, g + extend(w, need > g ? need - g : 0));
+                ++left[t];
+            }
+            memo[k] = {best, best > floor};
+            return best;
+        }
+
+        /**
+         * @brief Выкладывает лучшую цепочку из вершины v в группу chain.
+         */
+        void emit(int v, DominoGroup& chain) {
+            size_t target = extend(v, 0);
+            while (target > 0) {
+                for (int w = 0; w < PIPS; w++) {
+                    size_t t = tileOf[v * PIPS + w];
+                    if (left[t] == 0) continue;
+                    size_t g = gain(t);
+                    --left[t];
+                    size_t rest = extend(w, target > g ? target - g - 1 : 0);
+                    if (g + rest != target) {
+                        ++left[t];
+                        continue;
+                    }
+                    Domino tile(static_cast<std::uint8_t>(std::min(v, w)), static_cast<std::uint8_t>(std::max(v, w)));
+                    Domino forward = v <= w ? tile : ~tile;
+                    chain += forward;
+                    for (size_t extra = 1; extra < g; extra += 2) {
+                        chain += ~forward;
+                        chain += forward;
+                    }
+                    target = rest;
+                    v = w;
+                    break;
+                }
+            }
+        }
+
+        bool hasEdges(int v) const {
+            for (int w = 0; w < PIPS; w++) {
+                if (left[tileOf[v * PIPS + w]] > 0) return true;
+            }
+            return false;
+        }
+    };
+}
+
+DominoGroup DominoChain::longest(const DominoGroup& group, int start) {
+    if (start < -1 || start > 6) {
+        throw std::invalid_argument("Start value should be between 0 and 6");
+    }
+
+    ChainSearch search(group);
+    int bestStart = -1;
+    size_t bestLength = 0;
+    for (int v = 0; v < PIPS; v++) {
+        if ((start != -1 && v != start) || !search.hasEdges(v)) continue;
+        size_t length = search.extend(v, bestLength);
+        if (length > bestLength) {
+            bestLength = length;
+            bestStart = v;
+        }
+    }
+
+    DominoGroup chain;
+    if (bestStart != -1) {
+        search.emit(bestStart, chain);
+    }
+    return chain;
+}
+
+std::vector<DominoGroup> DominoChain::longestBatch(const std::vector<DominoGroup>& groups, int start, unsigned threads) {
+    std::vector<DominoGroup> chains(groups.size());
+    size_t workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+    workers = std::clamp<size_t>(std::min(workers, groups.size()), 1, 64);
+
+    auto solve = [&](size_t worker) {
+        for (size_t i = worker; i < groups.size(); i += workers) {
+            chains[i] = longest(groups[i], start);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t worker = 1; worker < workers; worker++) {
+        pool.emplace_back(solve, worker);
+    }
+    solve(0);
+    for (auto& thread : pool) thread.join();
+    return chains;
+}
@@ -0,0 +1,43 @@
+#ifndef DOMINOCHAIN_H
+#define DOMINOCHAIN_H
+
+#include <vector>
+#include "Domino.h"
+#include "DominoGroup.h"
+
+/**
+ * @class DominoChain
+ * @brief Поиск самой длинной цепочки (линии игры) из домино группы.
+ *
+ * Значения 0..6 рассматриваются как вершины мультиграфа, а домино — как его ребра
+ * (дубль — петля). Самая длинная цепочка — самый длинный путь по ребрам без повторов.
+ * Если оставшиеся ребра компоненты можно обойти эйлеровым путем из текущей вершины,
+ * ответ получается сразу; иначе выполняется перебор с запоминанием состояний
+ * (количества оставшихся домино каждого вида и текущая вершина). Полный набор из 28 домино
+ * решается сразу по эйлерову критерию.
+ */
+class DominoChain {
+public:
+    /**
+     * @brief Находит самую длинную цепочку домино из группы.
+     *
+     * Домино в результате развернуты (через operator~) так, что правая сторона каждого
+     * совпадает с левой стороной следующего.
+     * @param group Группа домино.
+     * @param start Значение, с которого должна начинаться цепочка (от 0 до 6), или -1 — любое.
+     * @return Цепочка домино в порядке выкладывания (пустая, если цепочку построить нельзя).
+     * @throws std::invalid_argument Если start не -1 и не находится в пределах от 0 до 6.
+     */
+    static DominoGroup longest(const DominoGroup& group, int start = -1);
+
+    /**
+     * @brief Находит самые длинные цепочки для множества групп.
+     * @param groups Группы домино.
+     * @param start Значение, с которого должна начинаться каждая цепочка, или -1 — любое.
+     * @param threads Количество потоков (0 — по числу ядер).
+     * @return Цепочки в том же порядке, что и группы.
+     */
+    static std::vector<DominoGroup> longestBatch(const std::vector<DominoGroup>& groups, int start = -1, unsigned threads = 1);
+};
+
+#endif
@@ -1,186 +1,1052 @@
 #include "DominoGroup.h"
+#include "DominoTables.h"
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
+#include <ranges>
+#include <cstring>
+#include <type_traits>
+#include <thread>
+#include <vector>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using std::cin;
 using std::cout;
 using std::endl;
 
 
-    DominoGroup::DominoGroup() noexcept : dominoes(nullptr), count(0), capacity(0) {}
+static_assert(std::is_trivially_copyable_v<Domino> && sizeof(Domino) == 2,
+              "DominoGroup copies dominoes with memcpy");
+static_assert(std::ranges::contiguous_range<DominoGroup> && std::ranges::sized_range<DominoGroup>,
+              "DominoGroup should work with std::ranges algorithms and views");
+
+namespace {
+    constexpr char FILE_MAGIC[4] = {'D', 'O', 'M', 'G'};
+
+    /**
+     * @brief Добавляет к counts количество домино [tiles, tiles + n) с каждым упорядоченным кодом.
+     *
+     * Соседние домино считаются в четыре разные гистограммы: повторяющиеся коды не ждут
+     * друг друга на одном счетчике, и проход ограничен чтением памяти, а не цепочкой записей.
+     * @param tiles Начало массива.
+     * @param n Количество домино.
+     * @param counts Счетчики по ORDERED_COUNT кодам.
+     */
+    template<int MaxPip>
+    void countCodes(const BasicDomino<MaxPip>* tiles, size_t n, std::uint64_t* counts) noexcept {
+        constexpr size_t ORDERED = BasicDomino<MaxPip>::ORDERED_COUNT;
+        constexpr size_t BLOCK = size_t(1) << 30; // 32-битные частичные счетчики не переполняются
+        std::uint32_t partial[4][ORDERED];
+        for (size_t begin = 0; begin < n; begin += BLOCK) {
+            std::memset(partial, 0, sizeof(partial));
+            size_t end = std::min(n, begin + BLOCK);
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                ++partial[0][tiles[i].code()];
+                ++partial[1][tiles[i + 1].code()];
+                ++partial[2][tiles[i + 2].code()];
+                ++partial[3][tiles[i + 3].code()];
+            }
+            for (; i < end; i++) {
+                ++partial[0][tiles[i].code()];
+            }
+            for (size_t code = 0; code < ORDERED; code++) {
+                counts[code] += std::uint64_t(partial[0][code]) + partial[1][code] + partial[2][code] + partial[3][code];
+            }
+        }
+    }
+
+    /**
+     * @brief Записывает не более size байт в файловый дескриптор.
+     * @return Количество записанных байт или -1 при ошибке.
+     */
+    long long writeDescriptor(int fd, const char* data, size_t size) {
+#ifdef _WIN32
+        return ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+#else
+        return ::write(fd, data, size);
+#endif
+    }
+
+    void writeU64(char* out, std::uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    std::uint64_t readU64(const char* in) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+        }
+        return value;
+    }
 
-    void DominoGroup::reserve(size_t newCapacity) {
+    void readExactly(std::istream& in, char* buffer, size_t size) {
+        if (size > 0 && !in.read(buffer, static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Unexpected end of domino file");
+        }
+    }
+}
+
+    void DominoFileHeader::write(char* out) const noexcept {
+        std::memcpy(out, FILE_MAGIC, sizeof(FILE_MAGIC));
+        out[4] = static_cast<char>(VERSION);
+        out[5] = static_cast<char>(maxPip);
+        out[6] = static_cast<char>(encoding);
+        out[7] = 0;
+        writeU64(out + 8, count);
+    }
+
+    DominoFileHeader DominoFileHeader::read(const char* in) {
+        if (std::memcmp(in, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+            throw std::runtime_error("Not a domino group file");
+        }
+        if (static_cast<std::uint8_t>(in[4]) != VERSION) {
+            throw std::runtime_error("Unsupported domino file version");
+        }
+        DominoFileHeader header;
+        header.maxPip = static_cast<std::uint8_t>(in[5]);
+        header.encoding = static_cast<DominoEncoding>(in[6]);
+        if (header.encoding != DominoEncoding::Codes && header.encoding != DominoEncoding::Histogram) {
+            throw std::runtime_error("Unknown domino file encoding");
+        }
+        header.count = readU64(in + 8);
+        return header;
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::BasicDominoGroup() noexcept : BasicDominoGroup(std::pmr::get_default_resource()) {}
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::BasicDominoGroup(std::pmr::memory_resource* resource) noexcept
+            : dominoes(nullptr), count(0), capacity(0), resource(resource), inlineTiles(nullptr), inlineCapacity(0),
+              tileCounts{}, tileHash(0) {}
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::BasicDominoGroup(Tile* buffer, size_t bufferCapacity, std::pmr::memory_resource* resource) noexcept
+            : dominoes(buffer), count(0), capacity(bufferCapacity), resource(resource), inlineTiles(buffer),
+              inlineCapacity(bufferCapacity), tileCounts{}, tileHash(0) {}
+
+    template<int MaxPip>
+    BasicDomino<MaxPip>* BasicDominoGroup<MaxPip>::allocate(size_t n) {
+        if (n > maxSize()) {
+            throw std::length_error("Domino group is too large");
+        }
+        DominoInstrumentation::add(DominoCounter::Allocations);
+        DominoInstrumentation::add(DominoCounter::BytesAllocated, n * sizeof(Tile));
+        return static_cast<Tile*>(resource->allocate(n * sizeof(Tile), alignof(Tile)));
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::deallocate() noexcept {
+        if (dominoes != nullptr && dominoes != inlineTiles) {
+            resource->deallocate(dominoes, capacity * sizeof(Tile), alignof(Tile));
+        }
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::rebuildIndex(unsigned threads) {
+        size_t workers = 1;
+        if (threads != 1 && count >= 2 * PARALLEL_SCAN_CHUNK) {
+            workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+            workers = std::clamp<size_t>(std::min(workers, count / PARALLEL_SCAN_CHUNK), 1, 64);
+        }
+        DominoScopeTimer timer(DominoOperation::RebuildIndex);
+        if (workers == 1) {
+            std::array<std::uint64_t, Tables::ORDERED_COUNT> codes{};
+            countCodes(dominoes, count, codes.data());
+            assignIndex(codes);
+            return;
+        }
+
+        // Каждый поток считает свой кусок в собственные счетчики, затем они складываются
+        std::vector<std::array<std::uint64_t, Tables::ORDERED_COUNT>> partial(workers);
+        size_t chunk = (count + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < workers; t++) {
+            size_t begin = std::min(count, t * chunk);
+            pool.emplace_back([this, &partial, t, begin, chunk] {
+                countCodes(dominoes + begin, std::min(count - begin, chunk), partial[t].data());
+            });
+        }
+        countCodes(dominoes, std::min(count, chunk), partial[0].data());
+        for (auto& thread : pool) thread.join();
+
+        for (size_t t = 1; t < workers; t++) {
+            for (size_t code = 0; code < Tables::ORDERED_COUNT; code++) {
+                partial[0][code] += partial[t][code];
+            }
+        }
+        assignIndex(partial[0]);
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::assignIndex(const std::array<std::uint64_t, Tables::ORDERED_COUNT>& codes) noexcept {
+        tileCounts.fill(0);
+        for (size_t code = 0; code < Tables::ORDERED_COUNT; code++) {
+            tileCounts[Tables::canonicalIndex[code]] += static_cast<size_t>(codes[code]);
+        }
+        tileHash = hashOf(tileCounts);
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::reserve(size_t newCapacity) {
         if (newCapacity > capacity) {
-            Domino* newDominoes = new Domino[newCapacity];
-            for (size_t i = 0; i < count; ++i) {
-                newDominoes[i] = dominoes[i];
+            DominoScopeTimer timer(DominoOperation::Reserve);
+            Tile* newDominoes = allocate(newCapacity);
+            if (count > 0) {
+                std::memcpy(newDominoes, dominoes, count * sizeof(Tile));
+                DominoInstrumentation::add(DominoCounter::BytesCopied, count * sizeof(Tile));
             }
-            delete[] dominoes;
+            deallocate();
             dominoes = newDominoes;
             capacity = newCapacity;
         }
     }
 
-    DominoGroup::~DominoGroup() {
-    delete[] dominoes;
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::shrinkToFit() {
+        if (capacity == count || isInline()) return;
+        if (count <= inlineCapacity) {
+            if (count > 0) {
+                std::memcpy(inlineTiles, dominoes, count * sizeof(Tile));
+                DominoInstrumentation::add(DominoCounter::BytesCopied, count * sizeof(Tile));
+            }
+            deallocate();
+            dominoes = inlineTiles;
+            capacity = inlineCapacity;
+            return;
+        }
+        Tile* newDominoes = count > 0 ? allocate(count) : nullptr;
+        if (count > 0) {
+            std::memcpy(newDominoes, dominoes, count * sizeof(Tile));
+            DominoInstrumentation::add(DominoCounter::BytesCopied, count * sizeof(Tile));
+        }
+        deallocate();
+        dominoes = newDominoes;
+        capacity = count;
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::clear() noexcept {
+        count = 0;
+        tileCounts.fill(0);
+        tileHash = 0;
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::getCapacity() const {
+        return capacity;
+    }
+
+    template<int MaxPip>
+    std::pmr::memory_resource* BasicDominoGroup<MaxPip>::getResource() const {
+        return resource;
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::BasicDominoGroup(const BasicDominoGroup& other) : BasicDominoGroup(other, std::pmr::get_default_resource()) {}
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::BasicDominoGroup(const BasicDominoGroup& other, std::pmr::memory_resource* resource) : BasicDominoGroup(resource) {
+        reserve(other.count);
+        if (other.count > 0) {
+            std::memcpy(dominoes, other.dominoes, other.count * sizeof(Tile));
+            DominoInstrumentation::add(DominoCounter::BytesCopied, other.count * sizeof(Tile));
+        }
+        count = other.count;
+        tileCounts = other.tileCounts;
+        tileHash = other.tileHash;
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::BasicDominoGroup(BasicDominoGroup&& other)
+            : BasicDominoGroup(other.resource) {
+        takeTiles(other);
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::takeTiles(BasicDominoGroup& other) {
+        bool fitsInline = inlineTiles != nullptr && other.count <= inlineCapacity;
+        if (!other.isInline() && !fitsInline) {
+            // Динамический массив передается вместе с источником памяти
+            deallocate();
+            dominoes = other.dominoes;
+            count = other.count;
+            capacity = other.capacity;
+            resource = other.resource;
+            tileCounts = other.tileCounts;
+            tileHash = other.tileHash;
+            other.resetToInline();
+            return;
+        }
+        if (fitsInline && !isInline()) {
+            deallocate();
+            dominoes = inlineTiles;
+            capacity = inlineCapacity;
+        }
+        if (other.count > capacity) {
+            Tile* newDominoes = allocate(other.count);
+            deallocate();
+            dominoes = newDominoes;
+            capacity = other.count;
+        }
+        if (other.count > 0) {
+            std::memcpy(dominoes, other.dominoes, other.count * sizeof(Tile));
+            DominoInstrumentation::add(DominoCounter::BytesCopied, other.count * sizeof(Tile));
+        }
+        count = other.count;
+        tileCounts = other.tileCounts;
+        tileHash = other.tileHash;
+        other.deallocate();
+        other.resetToInline();
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::resetToInline() noexcept {
+        dominoes = inlineTiles;
+        count = 0;
+        capacity = inlineCapacity;
+        tileCounts.fill(0);
+        tileHash = 0;
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip>::~BasicDominoGroup() {
+    deallocate();
 }
 
-    DominoGroup DominoGroup::createRandomGroup(size_t size) {
-        DominoGroup group;
-        group.reserve(size);
-        for (int i = 0; i < size; ++i) {
-            group.dominoes[group.count++] = Domino::generateRandomDomino();
+    template<int MaxPip>
+    void swap(BasicDominoGroup<MaxPip>& a, BasicDominoGroup<MaxPip>& b) {
+        if (a.isInline() || b.isInline()) {
+            if (a.isInline() && b.isInline() && a.count <= b.capacity && b.count <= a.capacity) {
+                // Оба набора помещаются в чужие буферы: обмен на месте
+                std::swap_ranges(a.dominoes, a.dominoes + std::max(a.count, b.count), b.dominoes);
+                std::swap(a.count, b.count);
+                std::swap(a.resource, b.resource);
+                std::swap(a.tileCounts, b.tileCounts);
+                std::swap(a.tileHash, b.tileHash);
+                return;
+            }
+            // Встроенный буфер остается на месте, обмениваются только домино
+            BasicDominoGroup<MaxPip> temporary(a.resource);
+            temporary.takeTiles(a);
+            a.takeTiles(b);
+            b.takeTiles(temporary);
+            return;
         }
-        return group;
+        std::swap(a.dominoes, b.dominoes);
+        std::swap(a.count, b.count);
+        std::swap(a.capacity, b.capacity);
+        std::swap(a.resource, b.resource);
+        std::swap(a.tileCounts, b.tileCounts);
+        std::swap(a.tileHash, b.tileHash);
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::createRandomGroup(size_t size) {
+        return createRandomGroup(size, DominoRng::threadLocal()());
     }
 
-    DominoGroup DominoGroup::generateFullSet(int repeat) {
-        DominoGroup group;
-        group.reserve(28 * repeat); // Максимум 28 домино в полном наборе
-        for (int i = 0; i <= 6; i++) {
-            for (int j = i; j <= 6; j++) {
-                for (int k = 0; k < repeat; ++k) {
-                    group.dominoes[group.count++] = Domino(i, j);
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::createRandomGroup(size_t size, std::uint64_t seed, unsigned threads) {
+        DominoScopeTimer timer(DominoOperation::CreateRandomGroup);
+        BasicDominoGroup group;
+        group.reserve(size);
+        group.count = size;
+
+        size_t blocks = (size + RANDOM_BLOCK - 1) / RANDOM_BLOCK;
+        size_t workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+        workers = std::clamp<size_t>(std::min(workers, blocks), 1, 64);
+
+        auto fill = [&group, size, seed, blocks, workers](size_t worker) {
+            for (size_t block = worker; block < blocks; block += workers) {
+                DominoRng gen(seed, block);
+                size_t end = std::min(size, (block + 1) * RANDOM_BLOCK);
+                for (size_t i = block * RANDOM_BLOCK; i < end; i++) {
+                    group.dominoes[i] = Tile::generateRandomDomino(gen);
                 }
             }
+        };
+
+        std::vector<std::thread> pool;
+        for (size_t worker = 1; worker < workers; worker++) {
+            pool.emplace_back(fill, worker);
         }
+        fill(0);
+        for (auto& thread : pool) thread.join();
+        group.rebuildIndex(threads);
         return group;
     }
 
-DominoGroup& DominoGroup::operator+=(const Domino& domino) {
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::generateFullSet(int repeat) {
+        DominoScopeTimer timer(DominoOperation::GenerateFullSet);
+        BasicDominoGroup group;
+        if (repeat <= 0) return group;
+        group.reserve(BasicDominoTables<MaxPip>::TILE_COUNT * repeat);
+        for (const Tile& tile : BasicDominoTables<MaxPip>::fullSet) {
+            std::fill_n(group.dominoes + group.count, repeat, tile);
+            group.count += repeat;
+        }
+        group.tileCounts.fill(static_cast<size_t>(repeat));
+        group.tileHash = hashOf(group.tileCounts);
+        return group;
+    }
+
+template<int MaxPip>
+BasicDominoGroup<MaxPip>& BasicDominoGroup<MaxPip>::operator+=(const Tile& domino) {
     if (count == capacity) {
         reserve(capacity == 0 ? 1 : capacity * 2);
     }
     dominoes[count++] = domino;
+    onInsert(domino);
     return *this;
 }
 
-    void DominoGroup::addRandomDomino() {
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::append(std::span<const Tile> tiles) {
+        if (tiles.empty()) return;
+        DominoScopeTimer timer(DominoOperation::Append);
+        // Если источник — часть этой группы, после перераспределения его адрес изменится
+        const bool own = tiles.data() >= dominoes && tiles.data() < dominoes + count;
+        const size_t offset = own ? static_cast<size_t>(tiles.data() - dominoes) : 0;
+        if (count + tiles.size() > capacity) {
+            reserve(std::max(count + tiles.size(), capacity * 2));
+        }
+        const Tile* source = own ? dominoes + offset : tiles.data();
+        std::memcpy(dominoes + count, source, tiles.size() * sizeof(Tile));
+        DominoInstrumentation::add(DominoCounter::BytesCopied, tiles.size() * sizeof(Tile));
+        for (size_t i = 0; i < tiles.size(); i++) {
+            onInsert(dominoes[count + i]);
+        }
+        count += tiles.size();
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::addRandomDomino() {
         if (count == capacity) {
             reserve(capacity == 0 ? 1 : capacity * 2);
         }
-        dominoes[count++] = Domino::generateRandomDomino();
+        dominoes[count++] = Tile::generateRandomDomino();
+        onInsert(dominoes[count - 1]);
     }
 
-    Domino DominoGroup::getRandomDomino() {
-        if (count == 0) throw std::runtime_error("Group is empty");
+    template<int MaxPip>
+    BasicDomino<MaxPip> BasicDominoGroup<MaxPip>::getRandomDomino() {
+        return getRandomDomino(DominoRng::threadLocal());
+    }
 
-        int index = rand() % count;
-        Domino removedDomino = dominoes[index];
-        --count;
-        for (int i = index; i < count; i++) {
-            dominoes[i] = dominoes[i + 1];
-        }
-        return removedDomino;
+    template<int MaxPip>
+    BasicDominoDeal<MaxPip> BasicDominoGroup<MaxPip>::deal(size_t players, size_t handSize) {
+        return deal(players, handSize, DominoRng::threadLocal());
     }
 
-    Domino DominoGroup::getDomino(int left, int right) {
+    template<int MaxPip>
+    BasicDomino<MaxPip> BasicDominoGroup<MaxPip>::getDomino(int left, int right) {
+        DominoScopeTimer timer(DominoOperation::GetDomino);
+        if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) {
+            throw std::invalid_argument("Specified domino not found");
+        }
+        const std::uint8_t target = static_cast<std::uint8_t>(BasicDominoTables<MaxPip>::canonical(left, right));
         for (size_t i = 0; i < count; i++) {
-            if ((dominoes[i].getLeft() == left && dominoes[i].getRight() == right) || (dominoes[i].getLeft() == right && dominoes[i].getRight() == left)) {
-                Domino removedDomino = dominoes[i];
-                for (size_t j = i; j < count - 1; j++) {
-                    dominoes[j] = dominoes[j + 1];
-                }
+            if (BasicDominoTables<MaxPip>::canonicalIndex[dominoes[i].code()] == target) {
+                Tile removedDomino = dominoes[i];
+                std::copy(dominoes + i + 1, dominoes + count, dominoes + i);
+                DominoInstrumentation::add(DominoCounter::Comparisons, i + 1);
+                DominoInstrumentation::add(DominoCounter::ElementsShifted, count - i - 1);
                 --count;
+                onErase(removedDomino);
                 return removedDomino;
             }
         }
+        DominoInstrumentation::add(DominoCounter::Comparisons, count);
         throw std::invalid_argument("Specified domino not found");
     }
 
-    Domino& DominoGroup::operator[](int index) {
-        if (index < 0 || index >= count) {
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::setDomino(int index, const Tile& domino) {
+        if (index < 0 || static_cast<size_t>(index) >= count) {
             throw std::out_of_range("Invalid index");
         }
-        return dominoes[index];
+        onErase(dominoes[index]);
+        dominoes[index] = domino;
+        onInsert(domino);
     }
 
-    const Domino& DominoGroup::operator[](int index) const {
-        if (index < 0 || index >= count) {
+    template<int MaxPip>
+    const BasicDomino<MaxPip>& BasicDominoGroup<MaxPip>::operator[](int index) const {
+        if (index < 0 || static_cast<size_t>(index) >= count) {
             throw std::out_of_range("Invalid index");
         }
         return dominoes[index];
     }
 
-    Domino DominoGroup::getByIndex(int index) {
-        if (index < 0 || index >= count) {
+    template<int MaxPip>
+    BasicDomino<MaxPip> BasicDominoGroup<MaxPip>::getByIndex(int index) {
+        DominoScopeTimer timer(DominoOperation::GetByIndex);
+        if (index < 0 || static_cast<size_t>(index) >= count) {
             throw std::out_of_range("Invalid index");
         }
 
-        Domino removedDomino = dominoes[index];
-        for (int i = index; i < count - 1; i++) {
-            dominoes[i] = dominoes[i + 1];
-        }
+        Tile removedDomino = dominoes[index];
+        std::copy(dominoes + index + 1, dominoes + count, dominoes + index);
+        DominoInstrumentation::add(DominoCounter::ElementsShifted, count - index - 1);
         --count;
+        onErase(removedDomino);
         return removedDomino;
     }
 
-    void DominoGroup::sortDominoes() {
-        std::sort(dominoes, dominoes + count, [](const Domino& a, const Domino& b) {
-            int sumA = a.getLeft() + a.getRight();
-            int sumB = b.getLeft() + b.getRight();
-            return sumA < sumB;
-        });
+    template<int MaxPip>
+    typename BasicDominoGroup<MaxPip>::Removal BasicDominoGroup<MaxPip>::takeDomino(int left, int right) {
+        if (countOf(left, right) == 0) {
+            throw std::invalid_argument("Specified domino not found");
+        }
+        const std::uint8_t target = static_cast<std::uint8_t>(Tables::canonical(left, right));
+        size_t index = 0;
+        while (Tables::canonicalIndex[dominoes[index].code()] != target) {
+            ++index;
+        }
+        DominoInstrumentation::add(DominoCounter::Comparisons, index + 1);
+        return takeByIndex(index);
     }
 
-    DominoGroup DominoGroup::getSubGroup(int value) {
-        DominoGroup subgroup;
-        for (size_t i = 0; i < count; ) {
-            if (dominoes[i].getLeft() == value || dominoes[i].getRight() == value) {
-                if (subgroup.count == subgroup.capacity) {
-                    subgroup.reserve(subgroup.capacity == 0 ? 1 : subgroup.capacity * 2);
-                }
-                subgroup.dominoes[subgroup.count++] = dominoes[i];
-                --count;
-                for (size_t j = i; j < count; j++) {
-                    dominoes[j] = dominoes[j + 1];
+    template<int MaxPip>
+    typename BasicDominoGroup<MaxPip>::Removal BasicDominoGroup<MaxPip>::takeByIndex(size_t index) {
+        if (index >= count) {
+            throw std::out_of_range("Invalid index");
+        }
+        Removal removal{dominoes[index], index};
+        dominoes[index] = dominoes[--count];
+        onErase(removal.domino);
+        return removal;
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::restore(const Removal& removal) noexcept {
+        // Домино, перенесенное на место удаленного, возвращается в конец
+        dominoes[count] = dominoes[removal.index];
+        dominoes[removal.index] = removal.domino;
+        ++count;
+        onInsert(removal.domino);
+    }
+
+    template<int MaxPip>
+    BasicDomino<MaxPip> BasicDominoGroup<MaxPip>::removeLast() {
+        if (count == 0) throw std::runtime_error("Group is empty");
+        Tile removedDomino = dominoes[--count];
+        onErase(removedDomino);
+        return removedDomino;
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::sortDominoes(const DominoSortOptions& options) {
+        if (count < 2) return;
+        DominoScopeTimer timer(DominoOperation::SortDominoes);
+
+        using Tables = BasicDominoTables<MaxPip>;
+
+        // Составной ключ для каждой упорядоченной пары (left, right)
+        size_t keyCount = 2 * MaxPip + 1;
+        if (options.byMaxSide) keyCount *= Tables::PIPS;
+        if (options.byOrientation) keyCount *= 2;
+        std::uint16_t keys[Tables::ORDERED_COUNT];
+        for (unsigned code = 0; code < Tables::ORDERED_COUNT; code++) {
+            unsigned l = code / Tables::PIPS;
+            unsigned r = code % Tables::PIPS;
+            size_t key = Tables::pipSum[code];
+            if (options.byMaxSide) key = key * Tables::PIPS + std::max(l, r);
+            if (options.byOrientation) key = key * 2 + (l > r ? 1 : 0);
+            if (options.descending) key = keyCount - 1 - key;
+            keys[code] = static_cast<std::uint16_t>(key);
+        }
+
+        if (isInline() && count <= INSERTION_SORT_LIMIT) {
+            // Рука во встроенном буфере мала: устойчивая сортировка вставками на месте, без выделения памяти
+            for (size_t i = 1; i < count; i++) {
+                Tile domino = dominoes[i];
+                std::uint16_t key = keys[domino.code()];
+                size_t j = i;
+                for (; j > 0 && keys[dominoes[j - 1].code()] > key; j--) {
+                    dominoes[j] = dominoes[j - 1];
                 }
+                dominoes[j] = domino;
+            }
+            return;
+        }
+
+        size_t threads = options.threads == 0 ? std::thread::hardware_concurrency() : options.threads;
+        threads = std::clamp<size_t>(std::min(threads, count / PARALLEL_SORT_CHUNK), 1, 64);
+
+        // Гистограмма ключей по каждому куску, затем смещения «ключ, потом кусок» — это сохраняет устойчивость
+        std::vector<size_t> offsets(threads * keyCount, 0);
+        size_t chunk = (count + threads - 1) / threads;
+        auto forEachChunk = [&](auto&& body) {
+            if (threads == 1) {
+                body(0, 0, count);
+                return;
+            }
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; t++) {
+                workers.emplace_back(body, t, t * chunk, std::min(count, (t + 1) * chunk));
+            }
+            for (auto& worker : workers) worker.join();
+        };
+
+        forEachChunk([&](size_t t, size_t begin, size_t end) {
+            size_t* histogram = offsets.data() + t * keyCount;
+            for (size_t i = begin; i < end; i++) {
+                ++histogram[keys[dominoes[i].code()]];
+            }
+        });
+
+        size_t position = 0;
+        for (size_t key = 0; key < keyCount; key++) {
+            for (size_t t = 0; t < threads; t++) {
+                size_t amount = offsets[t * keyCount + key];
+                offsets[t * keyCount + key] = position;
+                position += amount;
+            }
+        }
+
+        Tile* sorted = allocate(isInline() ? count : capacity);
+        forEachChunk([&](size_t t, size_t begin, size_t end) {
+            size_t* next = offsets.data() + t * keyCount;
+            for (size_t i = begin; i < end; i++) {
+                sorted[next[keys[dominoes[i].code()]]++] = dominoes[i];
+            }
+        });
+        if (isInline()) {
+            // Домино возвращаются во встроенный буфер, временный массив освобождается
+            std::memcpy(dominoes, sorted, count * sizeof(Tile));
+            DominoInstrumentation::add(DominoCounter::BytesCopied, count * sizeof(Tile));
+            resource->deallocate(sorted, count * sizeof(Tile), alignof(Tile));
+            return;
+        }
+        deallocate();
+        dominoes = sorted;
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::getSubGroup(int value) {
+        DominoScopeTimer timer(DominoOperation::GetSubGroup);
+        using Tables = BasicDominoTables<MaxPip>;
+        if (value < 0 || value > MaxPip) return BasicDominoGroup(resource);
+        const auto bit = static_cast<typename Tables::PipMask>(1u << value);
+        return extractIf([bit](const Tile& d) {
+            return (Tables::pipMask[d.code()] & bit) != 0;
+        });
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::countOf(int left, int right) const {
+        if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) return 0;
+        return tileCounts[Tables::canonical(left, right)];
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::countWithPip(int value) const {
+        return countPlayable(value, value);
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::countPlayable(int leftEnd, int rightEnd) const {
+        size_t total = 0;
+        forEachPlayable(leftEnd, rightEnd, [&total](const Tile&, size_t copies) {
+            total += copies;
+        });
+        return total;
+    }
+
+    template<int MaxPip>
+    typename BasicDominoTables<MaxPip>::TileMask BasicDominoGroup<MaxPip>::tileMask() const {
+        if constexpr (Tables::TILE_COUNT <= 64) {
+            // Маска помещается в одно слово: собираем ее без обращений к отдельным битам bitset
+            unsigned long long bits = 0;
+            for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+                bits |= static_cast<unsigned long long>(tileCounts[index] > 0) << index;
+            }
+            return typename Tables::TileMask(bits);
+        } else {
+            typename Tables::TileMask mask;
+            for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+                mask[index] = tileCounts[index] > 0;
+            }
+            return mask;
+        }
+    }
+
+    template<int MaxPip>
+    BasicDominoStatistics<MaxPip> BasicDominoGroup<MaxPip>::statistics() const {
+
+        BasicDominoStatistics<MaxPip> stats;
+        stats.tiles = count;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            size_t copies = tileCounts[index];
+            unsigned l = Tables::fullSet[index].getLeft();
+            unsigned r = Tables::fullSet[index].getRight();
+            stats.totalPips += static_cast<std::uint64_t>(copies) * (l + r);
+            stats.pipFaces[l] += copies;
+            stats.pipFaces[r] += copies;
+            stats.pipSums[l + r] += copies;
+            if (l == r) stats.doubles += copies;
+        }
+        return stats;
+    }
+
+    template<int MaxPip>
+    std::uint64_t BasicDominoGroup<MaxPip>::hash() const {
+        return tileHash;
+    }
+
+    template<int MaxPip>
+    bool BasicDominoGroup<MaxPip>::sameTiles(const BasicDominoGroup& other) const {
+        if (count != other.count) return false;
+        return tileCounts == other.tileCounts;
+    }
+
+    template<int MaxPip>
+    bool BasicDominoGroup<MaxPip>::isSubsetOf(const BasicDominoGroup& other) const {
+        if (count > other.count) return false;
+        // Без раннего выхода: цикл фиксированной длины компилятор векторизует
+        bool subset = true;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            subset &= tileCounts[index] <= other.tileCounts[index];
+        }
+        return subset;
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::setUnion(const BasicDominoGroup& other) const {
+        std::array<size_t, Tables::TILE_COUNT> counts;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            counts[index] = std::max(tileCounts[index], other.tileCounts[index]);
+        }
+        return fromCounts(counts, resource);
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::setIntersection(const BasicDominoGroup& other) const {
+        std::array<size_t, Tables::TILE_COUNT> counts;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            counts[index] = std::min(tileCounts[index], other.tileCounts[index]);
+        }
+        return fromCounts(counts, resource);
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::setDifference(const BasicDominoGroup& other) const {
+        std::array<size_t, Tables::TILE_COUNT> counts;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            counts[index] = tileCounts[index] - std::min(tileCounts[index], other.tileCounts[index]);
+        }
+        return fromCounts(counts, resource);
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::fromCounts(const std::array<size_t, Tables::TILE_COUNT>& counts,
+                                                                  std::pmr::memory_resource* resource) {
+        BasicDominoGroup group(resource);
+        size_t total = 0;
+        for (size_t copies : counts) {
+            total += copies;
+        }
+        group.reserve(total);
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            std::fill_n(group.dominoes + group.count, counts[index], Tables::fullSet[index]);
+            group.count += counts[index];
+        }
+        group.tileCounts = counts;
+        group.tileHash = hashOf(counts);
+        return group;
+    }
+
+    template<int MaxPip>
+    char* BasicDominoGroup<MaxPip>::renderRange(char* out, size_t begin, size_t end, size_t perRow) const {
+        for (size_t i = begin; i < end; i += perRow) {
+            out = Tile::renderRow(out, dominoes + i, std::min(perRow, end - i));
+        }
+        return out;
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::printGroup(std::ostream& out, size_t perRow) const {
+        perRow = std::max<size_t>(perRow, 1);
+        size_t rowsPerChunk = std::max<size_t>(1, PRINT_CHUNK / Tile::renderedRowSize(perRow));
+        size_t tilesPerChunk = rowsPerChunk * perRow;
+
+        std::string buffer(Tile::renderedRowSize(perRow) * rowsPerChunk + 1, '\0');
+        for (size_t begin = 0; begin < count; begin += tilesPerChunk) {
+            char* end = renderRange(buffer.data(), begin, std::min(count, begin + tilesPerChunk), perRow);
+            out.write(buffer.data(), end - buffer.data());
+        }
+        out << endl;
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::renderedSize(size_t perRow) const {
+        perRow = std::max<size_t>(perRow, 1);
+        size_t fullRows = count / perRow;
+        return fullRows * Tile::renderedRowSize(perRow) + Tile::renderedRowSize(count % perRow) + 1;
+    }
+
+    template<int MaxPip>
+    std::string BasicDominoGroup<MaxPip>::render(size_t perRow) const {
+        std::string picture(renderedSize(perRow), '\0');
+        render(picture.data(), picture.size(), perRow);
+        return picture;
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::render(char* buffer, size_t bufferSize, size_t perRow) const {
+        size_t required = renderedSize(perRow);
+        if (required > bufferSize) return required;
+        char* end = renderRange(buffer, 0, count, std::max<size_t>(perRow, 1));
+        *end = '\n';
+        return required;
+    }
+
+    template<int MaxPip>
+    char* BasicDominoGroup<MaxPip>::formatRange(char* out, size_t begin, size_t end) const noexcept {
+        for (size_t i = begin; i < end; i++) {
+            unsigned code = dominoes[i].code();
+            if constexpr (MaxPip < 10) {
+                // Все записи одной длины: копирование постоянного размера без ветвлений
+                std::memcpy(out, Tables::text[code].data(), Tables::TEXT_WIDTH);
+                out += Tables::TEXT_WIDTH;
             } else {
-                i++;
+                std::memcpy(out, Tables::text[code].data(), Tables::textLength[code]);
+                out += Tables::textLength[code];
             }
         }
-        return subgroup;
+        return out;
     }
 
-    void DominoGroup::printGroup() const {
-        for (size_t i = 0; i < count; i++) {
-            dominoes[i].print();
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::formattedSize() const noexcept {
+        if constexpr (MaxPip < 10) {
+            return count * Tables::TEXT_WIDTH;
+        } else {
+            size_t total = 0;
+            for (size_t i = 0; i < count; i++) {
+                total += Tables::textLength[dominoes[i].code()];
+            }
+            return total;
+        }
+    }
+
+    template<int MaxPip>
+    std::string BasicDominoGroup<MaxPip>::format() const {
+        std::string text(formattedSize(), '\0');
+        formatRange(text.data(), 0, count);
+        return text;
+    }
+
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::format(char* buffer, size_t bufferSize) const noexcept {
+        size_t required = formattedSize();
+        if (required > bufferSize) return required;
+        formatRange(buffer, 0, count);
+        return required;
+    }
+
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::writeText(int fd) const {
+        constexpr size_t tilesPerChunk = PRINT_CHUNK / Tables::TEXT_WIDTH;
+        std::string buffer(std::min(count, tilesPerChunk) * Tables::TEXT_WIDTH, '\0');
+        for (size_t begin = 0; begin < count; begin += tilesPerChunk) {
+            const char* data = buffer.data();
+            const char* end = formatRange(buffer.data(), begin, std::min(count, begin + tilesPerChunk));
+            while (data < end) {
+                auto written = writeDescriptor(fd, data, static_cast<size_t>(end - data));
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) throw std::runtime_error("Cannot write domino text");
+                data += written;
+            }
         }
-        cout << endl;
     }
 
-    size_t DominoGroup::size() const {
+    template<int MaxPip>
+    size_t BasicDominoGroup<MaxPip>::size() const {
         return count;
     }
 
+    template<int MaxPip>
+    void BasicDominoGroup<MaxPip>::save(std::ostream& out, DominoEncoding encoding) const {
+        DominoScopeTimer timer(DominoOperation::Save);
+        DominoFileHeader header;
+        header.maxPip = MaxPip;
+        header.encoding = encoding;
+        header.count = count;
+        char head[DominoFileHeader::SIZE];
+        header.write(head);
+        out.write(head, sizeof(head));
+
+        if (encoding == DominoEncoding::Histogram) {
+            char counts[Tables::TILE_COUNT * 8];
+            for (size_t i = 0; i < Tables::TILE_COUNT; i++) {
+                writeU64(counts + 8 * i, tileCounts[i]);
+            }
+            out.write(counts, sizeof(counts));
+            return;
+        }
+
+        std::string buffer(std::min(count, IO_CHUNK), '\0');
+        for (size_t begin = 0; begin < count; begin += IO_CHUNK) {
+            size_t end = std::min(count, begin + IO_CHUNK);
+            for (size_t i = begin; i < end; i++) {
+                buffer[i - begin] = static_cast<char>(dominoes[i].code());
+            }
+            out.write(buffer.data(), static_cast<std::streamsize>(end - begin));
+        }
+    }
+
+    template<int MaxPip>
+    BasicDominoGroup<MaxPip> BasicDominoGroup<MaxPip>::load(std::istream& in) {
+        DominoScopeTimer timer(DominoOperation::Load);
+        char head[DominoFileHeader::SIZE];
+        readExactly(in, head, sizeof(head));
+        DominoFileHeader header = DominoFileHeader::read(head);
+        if (header.maxPip != MaxPip) {
+            throw std::runtime_error("Domino file holds a different pip range");
+        }
+        // Заявленный размер не доверенный: без этой проверки массив под него может переполнить size_t
+        if (header.count > maxSize()) {
+            throw std::runtime_error("Domino file declares too many dominoes");
+        }
+
+        BasicDominoGroup group;
+        if (header.encoding == DominoEncoding::Histogram) {
+            char counts[Tables::TILE_COUNT * 8];
+            readExactly(in, counts, sizeof(counts));
+            // Каждое количество не больше оставшейся части header.count, поэтому сумма не переполняется
+            std::uint64_t total = 0;
+            for (size_t i = 0; i < Tables::TILE_COUNT; i++) {
+                std::uint64_t tiles = readU64(counts + 8 * i);
+                if (tiles > header.count - total) {
+                    throw std::runtime_error("Domino file histogram does not match its size");
+                }
+                total += tiles;
+                group.tileCounts[i] = static_cast<size_t>(tiles);
+            }
+            if (total != header.count) {
+                throw std::runtime_error("Domino file histogram does not match its size");
+            }
+            group.reserve(static_cast<size_t>(total));
+            for (size_t i = 0; i < Tables::TILE_COUNT; i++) {
+                std::fill_n(group.dominoes + group.count, group.tileCounts[i], Tables::fullSet[i]);
+                group.count += group.tileCounts[i];
+            }
+            group.tileHash = hashOf(group.tileCounts);
+            return group;
+        }
+
+        // Читаем кусками: для обрезанного файла не выделяем память под заявленный размер сразу
+        std::string buffer(std::min<std::uint64_t>(header.count, IO_CHUNK), '\0');
+        for (std::uint64_t begin = 0; begin < header.count; begin += IO_CHUNK) {
+            size_t chunk = static_cast<size_t>(std::min<std::uint64_t>(header.count - begin, IO_CHUNK));
+            readExactly(in, buffer.data(), chunk);
+            group.reserve(std::max(group.count + chunk, std::min<size_t>(header.count, group.capacity * 2)));
+
+            unsigned invalid = 0;
+            Tile* out = group.dominoes + group.count;
+            for (size_t i = 0; i < chunk; i++) {
+                unsigned code = static_cast<unsigned char>(buffer[i]);
+                invalid |= code >= Tables::ORDERED_COUNT;
+                out[i] = Tile::fromCode(code);
+            }
+            if (invalid) {
+                throw std::runtime_error("Invalid domino code in file");
+            }
+            group.count += chunk;
+        }
+        group.rebuildIndex(1);
+        return group;
+    }
+
 
-DominoGroup& DominoGroup::operator=(const DominoGroup& other) {
+template<int MaxPip>
+BasicDominoGroup<MaxPip>& BasicDominoGroup<MaxPip>::operator=(const BasicDominoGroup& other) {
     if (this == &other) return *this;
-    delete[] dominoes;
-    count = other.count;
-    capacity = other.capacity;
-    dominoes = new Domino[capacity];
-    for (size_t i = 0; i < count; i++) {
-        dominoes[i] = other.dominoes[i];
+    if (other.count > capacity) {
+        Tile* newDominoes = allocate(other.count);
+        deallocate();
+        dominoes = newDominoes;
+        capacity = other.count;
+    }
+    if (other.count > 0) {
+        std::memcpy(dominoes, other.dominoes, other.count * sizeof(Tile));
+        DominoInstrumentation::add(DominoCounter::BytesCopied, other.count * sizeof(Tile));
     }
+    count = other.count;
+    tileCounts = other.tileCounts;
+    tileHash = other.tileHash;
     return *this;
 }
 
-    std::istream& operator>>(std::istream& in, DominoGroup& group) {
-        int size;
-        in >> size;
-        group.reserve(size);
-        group.count = size;
-        for (int i = 0; i < size; i++) {
-            in >> group.dominoes[i];
+template<int MaxPip>
+BasicDominoGroup<MaxPip>& BasicDominoGroup<MaxPip>::operator=(BasicDominoGroup&& other) {
+    if (this == &other) return *this;
+    takeTiles(other);
+    return *this;
+}
+
+    template<int MaxPip>
+    std::istream& operator>>(std::istream& in, BasicDominoGroup<MaxPip>& group) {
+        long long size;
+        if (!(in >> size)) return in;
+        if (size < 0) {
+            in.setstate(std::ios::failbit);
+            return in;
+        }
+
+        // Заявленный размер не выделяется сразу: он может быть ошибочным
+        BasicDominoGroup<MaxPip> parsed(group.resource);
+        parsed.reserve(std::min<size_t>(static_cast<size_t>(size), BasicDominoGroup<MaxPip>::IO_CHUNK));
+        BasicDomino<MaxPip> domino;
+        for (long long i = 0; i < size; i++) {
+            if (!(in >> domino)) return in;
+            parsed += domino;
         }
+        group = std::move(parsed);
         return in;
     }
 
-    std::ostream& operator<<(std::ostream& out, const DominoGroup& group) {
-        for (size_t i = 0; i < group.count; i++) {
-            out << group.dominoes[i] << " ";
+    template<int MaxPip>
+    std::ostream& operator<<(std::ostream& out, const BasicDominoGroup<MaxPip>& group) {
+        using Tables = typename BasicDominoGroup<MaxPip>::Tables;
+        constexpr size_t tilesPerChunk = BasicDominoGroup<MaxPip>::PRINT_CHUNK / Tables::TEXT_WIDTH;
+        std::string buffer(std::min(group.count, tilesPerChunk) * Tables::TEXT_WIDTH, '\0');
+        for (size_t begin = 0; begin < group.count && out; begin += tilesPerChunk) {
+            char* end = group.formatRange(buffer.data(), begin, std::min(group.count, begin + tilesPerChunk));
+            out.write(buffer.data(), end - buffer.data());
         }
         return out;
     }
+
+template class BasicDominoGroup<6>;
+template class BasicDominoGroup<9>;
+template class BasicDominoGroup<12>;
+template class BasicDominoGroup<15>;
+
+template void swap(BasicDominoGroup<6>&, BasicDominoGroup<6>&);
+template void swap(BasicDominoGroup<9>&, BasicDominoGroup<9>&);
+template void swap(BasicDominoGroup<12>&, BasicDominoGroup<12>&);
+template void swap(BasicDominoGroup<15>&, BasicDominoGroup<15>&);
+
+template std::istream& operator>>(std::istream&, BasicDominoGroup<6>&);
+template std::istream& operator>>(std::istream&, BasicDominoGroup<9>&);
+template std::istream& operator>>(std::istream&, BasicDominoGroup<12>&);
+template std::istream& operator>>(std::istream&, BasicDominoGroup<15>&);
+
+template std::ostream& operator<<(std::ostream&, const BasicDominoGroup<6>&);
+template std::ostream& operator<<(std::ostream&, const BasicDominoGroup<9>&);
+template std::ostream& operator<<(std::ostream&, const BasicDominoGroup<12>&);
+template std::ostream& operator<<(std::ostream&, const BasicDominoGroup<15>&);
@@ -1,74 +1,428 @@
 #ifndef DOMINOGROUP_H
 #define DOMINOGROUP_H
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <string>
 #include <vector>
 #include "Domino.h"
+#include "DominoTables.h"
+#include "DominoInstrumentation.h"
 
 /**
- * @class DominoGroup
+ * @struct DominoSortOptions
+ * @brief Параметры сортировки DominoGroup::sortDominoes.
+ *
+ * Первичный ключ всегда сумма сторон (0..2 * MaxPip). Дополнительные ключи уточняют порядок
+ * внутри одинаковых сумм. Сортировка устойчивая: домино с одинаковыми ключами сохраняют
+ * взаимный порядок.
+ */
+struct DominoSortOptions {
+    bool byMaxSide = false;     /**< Второй ключ: большая из сторон. */
+    bool byOrientation = false; /**< Третий ключ: сначала домино с left <= right, затем перевернутые. */
+    bool descending = false;    /**< Сортировать по убыванию ключей. */
+    unsigned threads = 1;       /**< Количество потоков (0 — по числу ядер). */
+};
+
+/**
+ * @struct BasicDominoStatistics
+ * @brief Сводная статистика группы домино, см. BasicDominoGroup::statistics.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+struct BasicDominoStatistics {
+    size_t tiles = 0;                                        /**< Количество домино. */
+    std::uint64_t totalPips = 0;                             /**< Сумма значений всех сторон. */
+    size_t doubles = 0;                                      /**< Количество дублей. */
+    std::array<size_t, MaxPip + 1> pipFaces{};               /**< Количество сторон со значением v (дубль дает две). */
+    std::array<size_t, 2 * MaxPip + 1> pipSums{};            /**< Количество домино с суммой сторон s. */
+};
+
+/**
+ * @enum DominoEncoding
+ * @brief Способ кодирования домино в двоичном файле группы.
+ */
+enum class DominoEncoding : std::uint8_t {
+    Codes = 0,    /**< Один байт на домино — упорядоченный код left * PIPS + right; порядок и ориентация сохраняются. */
+    Histogram = 1 /**< Количество каждой кости (8 байт на кость); порядок и ориентация не сохраняются. */
+};
+
+/**
+ * @struct DominoFileHeader
+ * @brief Заголовок двоичного файла группы домино (16 байт).
+ *
+ * Формат: сигнатура "DOMG", версия, наибольшее значение стороны, способ кодирования,
+ * резервный байт и количество домино (8 байт, little-endian). Затем следуют данные в
+ * соответствии с DominoEncoding.
+ */
+struct DominoFileHeader {
+    static constexpr size_t SIZE = 16;           /**< Размер заголовка в байтах. */
+    static constexpr std::uint8_t VERSION = 1;   /**< Текущая версия формата. */
+
+    std::uint8_t maxPip = 6;                     /**< Наибольшее значение стороны набора. */
+    DominoEncoding encoding = DominoEncoding::Codes; /**< Способ кодирования данных. */
+    std::uint64_t count = 0;                     /**< Количество домино в группе. */
+
+    /**
+     * @brief Записывает заголовок в буфер.
+     * @param out Буфер не меньше SIZE байт.
+     */
+    void write(char* out) const noexcept;
+
+    /**
+     * @brief Разбирает заголовок из буфера.
+     * @param in Буфер не меньше SIZE байт.
+     * @return Заголовок.
+     * @throws std::runtime_error Если сигнатура, версия или способ кодирования неизвестны.
+     */
+    static DominoFileHeader read(const char* in);
+};
+
+template<int MaxPip>
+struct BasicDominoDeal;
+
+template<int MaxPip, size_t N = BasicDominoTables<MaxPip>::TILE_COUNT>
+class BasicInlineDominoGroup;
+
+/**
+ * @class BasicDominoGroup
  * @brief Класс, представляющий группу домино.
  *
- * DominoGroup предоставляет возможность создавать наборы домино, добавлять и удалять домино, сортировать и выводить их.
+ * BasicDominoGroup предоставляет возможность создавать наборы домино, добавлять и удалять домино, сортировать и выводить их.
+ * Память выделяется из std::pmr::memory_resource (по умолчанию — std::pmr::get_default_resource()),
+ * поэтому руки игроков можно размещать, например, в арене std::pmr::monotonic_buffer_resource.
+ * Руки, которые не должны выделять память вовсе, удобнее хранить в BasicInlineDominoGroup.
+ * Диапазон значений домино — параметр шаблона; классическая группа 0..6 доступна под именем DominoGroup.
+ *
+ * Группа поддерживает индекс — количество экземпляров каждой кости. Он обновляется за O(1)
+ * при добавлении и удалении, поэтому запросы «какие домино можно приставить к концам линии»
+ * не копируют и не просматривают группу. Массовые изменения (createRandomGroup, load,
+ * updateTiles) пересчитывают индекс один раз в конце. Индекс всегда согласован с массивом,
+ * а константные методы ничего не изменяют, поэтому группу можно читать из нескольких потоков.
+ * @tparam MaxPip Наибольшее значение стороны (6, 9, 12 или 15).
  */
-class DominoGroup {
+template<int MaxPip>
+class BasicDominoGroup {
+public:
+    using Tile = BasicDomino<MaxPip>;         /**< Тип домино группы. */
+    using Tables = BasicDominoTables<MaxPip>; /**< Таблицы набора. */
+    using value_type = Tile;                  /**< Тип элемента (для совместимости с контейнерами). */
+    using size_type = size_t;                 /**< Тип размера. */
+    using const_iterator = const Tile*;       /**< Непрерывный итератор только для чтения. */
+    using iterator = const_iterator;          /**< Итераторы группы только читают: запись не должна обходить индекс. */
+
+    /**
+     * @struct Removal
+     * @brief Запись об удалении домино, по которой restore возвращает группу в прежнее состояние.
+     */
+    struct Removal {
+        Tile domino;  /**< Удаленное домино в его ориентации. */
+        size_t index; /**< Позиция, которую домино занимало в группе. */
+    };
+
 private:
-    Domino* dominoes;   /**< Указатель на динамически выделенный массив домино. */
+    Tile* dominoes;     /**< Указатель на массив домино: динамический или встроенный буфер. */
     size_t count;       /**< Текущее количество домино в группе. */
     size_t capacity;    /**< Текущая вместимость группы (размер выделенной памяти). */
+    std::pmr::memory_resource* resource; /**< Источник памяти для массива домино. */
+    Tile* inlineTiles;      /**< Встроенный буфер BasicInlineDominoGroup или nullptr. */
+    size_t inlineCapacity;  /**< Вместимость встроенного буфера. */
+    std::array<size_t, Tables::TILE_COUNT> tileCounts; /**< Индекс: количество каждой кости в каноническом порядке. */
+    std::uint64_t tileHash; /**< Хеш Зобриста по индексу: сумма ключей всех домино, см. hash(). */
+
+    static constexpr size_t PARALLEL_SORT_CHUNK = 1 << 16; /**< Минимальный кусок на поток при параллельной сортировке. */
+    static constexpr size_t INSERTION_SORT_LIMIT = 64;     /**< Наибольшая встроенная группа, сортируемая вставками. */
+    static constexpr size_t RANDOM_BLOCK = 1 << 16;        /**< Размер блока с собственным потоком случайных чисел. */
+    static constexpr size_t PRINT_CHUNK = 1 << 16;         /**< Примерный размер куска вывода printGroup в байтах. */
+    static constexpr size_t IO_CHUNK = 1 << 16;            /**< Размер куска двоичного ввода-вывода в домино. */
+    static constexpr size_t PARALLEL_SCAN_CHUNK = 1 << 20; /**< Минимальный кусок на поток при параллельном подсчете. */
 
     /**
-     * @brief Расширяет внутренний массив домино, если текущее количество домино равно вместимости.
-     * @param newCapacity Новая вместимость массива домино.
+     * @brief Рисует домино с индексами [begin, end) рядами по perRow в буфер.
+     * @param out Буфер достаточного размера.
+     * @param begin Индекс первого домино.
+     * @param end Индекс после последнего домино.
+     * @param perRow Количество домино в одном ряду.
+     * @return Указатель на байт, следующий за последним записанным.
      */
-    void reserve(size_t newCapacity);
+    char* renderRange(char* out, size_t begin, size_t end, size_t perRow) const;
+
+    /**
+     * @brief Записывает текст "(l|r) " домино с индексами [begin, end) в буфер.
+     * @param out Буфер достаточного размера.
+     * @param begin Индекс первого домино.
+     * @param end Индекс после последнего домино.
+     * @return Указатель на байт, следующий за последним записанным.
+     */
+    char* formatRange(char* out, size_t begin, size_t end) const noexcept;
+
+    /**
+     * @brief Строит группу по количеству каждой кости: кости в каноническом порядке и ориентации.
+     * @param counts Количество экземпляров каждой кости.
+     * @param resource Источник памяти новой группы.
+     * @return Новая группа.
+     */
+    static BasicDominoGroup fromCounts(const std::array<size_t, Tables::TILE_COUNT>& counts,
+                                       std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Выделяет неинициализированную память под n домино.
+     * @param n Количество домино.
+     * @return Указатель на выделенную память.
+     * @throws std::length_error Если n больше maxSize().
+     */
+    Tile* allocate(size_t n);
+
+    /**
+     * @brief Возвращает массив домино источнику памяти (встроенный буфер не освобождается).
+     */
+    void deallocate() noexcept;
+
+    /**
+     * @brief Проверяет, хранятся ли домино во встроенном буфере.
+     * @return true, если массив группы — встроенный буфер.
+     */
+    bool isInline() const noexcept {
+        return inlineTiles != nullptr && dominoes == inlineTiles;
+    }
+
+    /**
+     * @brief Делает группу пустой, оставляя ей встроенный буфер, если он есть.
+     */
+    void resetToInline() noexcept;
+
+    /**
+     * @brief Учитывает в индексе добавленное домино.
+     * @param domino Добавленное домино.
+     */
+    void onInsert(const Tile& domino) noexcept {
+        size_t index = Tables::canonicalIndex[domino.code()];
+        ++tileCounts[index];
+        tileHash += Tables::zobrist[index];
+    }
+
+    /**
+     * @brief Учитывает в индексе удаленное домино.
+     * @param domino Удаленное домино.
+     */
+    void onErase(const Tile& domino) noexcept {
+        size_t index = Tables::canonicalIndex[domino.code()];
+        --tileCounts[index];
+        tileHash -= Tables::zobrist[index];
+    }
+
+    /**
+     * @brief Вычисляет хеш Зобриста по количеству каждой кости за O(TILE_COUNT).
+     * @param counts Количество экземпляров каждой кости.
+     * @return Сумма ключей всех домино.
+     */
+    static std::uint64_t hashOf(const std::array<size_t, Tables::TILE_COUNT>& counts) noexcept {
+        std::uint64_t hash = 0;
+        for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+            hash += Tables::zobrist[index] * counts[index];
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Пересчитывает индекс за один проход по массиву после массового изменения, при необходимости в нескольких потоках.
+     * @param threads Количество потоков (0 — по числу ядер).
+     */
+    void rebuildIndex(unsigned threads);
+
+    /**
+     * @brief Заполняет индекс по количеству каждого упорядоченного кода.
+     * @param codes Количество домино с каждым кодом left * PIPS + right.
+     */
+    void assignIndex(const std::array<std::uint64_t, Tables::ORDERED_COUNT>& codes) noexcept;
+
+protected:
+    /**
+     * @brief Создает пустую группу, которая хранит домино во внешнем встроенном буфере.
+     *
+     * Используется BasicInlineDominoGroup: пока домино помещаются в буфер, память не
+     * выделяется, при росте сверх bufferCapacity массив переносится в resource.
+     * @param buffer Буфер на bufferCapacity домино; должен жить дольше группы.
+     * @param bufferCapacity Вместимость буфера.
+     * @param resource Источник памяти для массивов больше буфера.
+     */
+    BasicDominoGroup(Tile* buffer, size_t bufferCapacity, std::pmr::memory_resource* resource) noexcept;
+
+    /**
+     * @brief Переносит домино other в эту группу; other становится пустой.
+     *
+     * Динамический массив other забирается вместе с источником памяти, если домино не помещаются
+     * во встроенный буфер этой группы. Иначе домино копируются: во встроенный буфер, в текущий
+     * массив или, если массив other встроенный и места не хватает, в новый массив.
+     * @param other Группа-источник.
+     * @throws std::bad_alloc Только если массив other встроенный и не помещается в эту группу.
+     */
+    void takeTiles(BasicDominoGroup& other);
+
 public:
     /**
      * @brief Конструктор по умолчанию, создающий пустую группу домино.
      */
-    DominoGroup() noexcept;
+    BasicDominoGroup() noexcept;
+
+    /**
+     * @brief Создает пустую группу, выделяющую память из указанного источника.
+     * @param resource Источник памяти; должен жить дольше группы.
+     */
+    explicit BasicDominoGroup(std::pmr::memory_resource* resource) noexcept;
     /**
    * @brief Деструктор, освобождающий динамически выделенную память.
    */
-    ~DominoGroup();
+    ~BasicDominoGroup();
+
+    /**
+     * @brief Конструктор копирования.
+     *
+     * Копия использует источник памяти по умолчанию, как и копии std::pmr-контейнеров.
+     * @param other Группа домино для копирования.
+     */
+    BasicDominoGroup(const BasicDominoGroup& other);
+
+    /**
+     * @brief Конструктор копирования в указанный источник памяти.
+     * @param other Группа домино для копирования.
+     * @param resource Источник памяти для копии.
+     */
+    BasicDominoGroup(const BasicDominoGroup& other, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Конструктор перемещения: забирает массив и источник памяти, other становится пустой.
+     *
+     * Динамический массив забирается без выделения памяти. Встроенная группа, переданная как
+     * BasicDominoGroup&&, хранит домино в собственном буфере, поэтому они копируются в новый
+     * массив; из-за этого конструктор не объявлен noexcept.
+     * @param other Перемещаемая группа.
+     * @throws std::bad_alloc Только если other — встроенная группа и не удалось выделить память.
+     */
+    BasicDominoGroup(BasicDominoGroup&& other);
+
+    /**
+     * @brief Перемещает встроенную группу: домино из ее буфера копируются, динамический массив забирается.
+     * @param other Перемещаемая группа.
+     * @throws std::bad_alloc Если не удалось выделить память под домино из встроенного буфера.
+     */
+    template<size_t N>
+    BasicDominoGroup(BasicInlineDominoGroup<MaxPip, N>&& other) : BasicDominoGroup(other.getResource()) {
+        takeTiles(other);
+    }
 
     /**
      * @brief Конструктор, принимающий список инициализации.
      * @param initList Список домино для инициализации группы.
      */
-    DominoGroup(std::initializer_list<Domino> initList) : dominoes(nullptr), count(0), capacity(0) {
+    BasicDominoGroup(std::initializer_list<Tile> initList) : BasicDominoGroup() {
+        reserve(initList.size());
+        std::copy(initList.begin(), initList.end(), dominoes);
         count = initList.size();
-        capacity = count;
+        for (const Tile& domino : initList) onInsert(domino);
+    }
+
+    /**
+     * @brief Увеличивает вместимость группы не меньше чем до newCapacity.
+     *
+     * Новый массив не инициализируется, существующие домино переносятся одним memcpy.
+     * @param newCapacity Новая вместимость массива домино.
+     * @throws std::length_error Если newCapacity больше maxSize().
+     */
+    void reserve(size_t newCapacity);
 
-        if (count > 0) {
-            dominoes = new Domino[count];
+    /**
+     * @brief Уменьшает вместимость до текущего количества домино.
+     *
+     * Если домино помещаются во встроенный буфер, они возвращаются в него.
+     */
+    void shrinkToFit();
 
-            int index = 0;
-            for (const auto& d : initList) {
-                dominoes[index++] = d;
-            }
-        }
+    /**
+     * @brief Удаляет все домино, сохраняя вместимость.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Возвращает текущую вместимость группы.
+     * @return Количество домино, которое поместится без перераспределения памяти.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Возвращает наибольшее количество домино, которое может храниться в группе.
+     *
+     * Размер массива в байтах должен помещаться в std::ptrdiff_t, как у std::vector::max_size.
+     * @return Предельный размер группы.
+     */
+    static constexpr size_t maxSize() noexcept {
+        return static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(Tile);
     }
 
+    /**
+     * @brief Возвращает источник памяти группы.
+     * @return Указатель на источник памяти.
+     */
+    std::pmr::memory_resource* getResource() const;
+
+    /**
+     * @brief Обменивает содержимое двух групп вместе с источниками памяти.
+     *
+     * Динамические массивы обмениваются указателями, домино во встроенных буферах копируются.
+     * Память выделяется, только если домино из встроенного буфера не помещаются в другую группу.
+     * @param a Первая группа.
+     * @param b Вторая группа.
+     * @throws std::bad_alloc Если не удалось выделить такую память.
+     */
+    template<int P>
+    friend void swap(BasicDominoGroup<P>& a, BasicDominoGroup<P>& b);
+
 
     /**
      * @brief Создает группу случайных домино указанного размера.
      * @param size Количество домино в группе.
      * @return Группа случайных домино.
      */
-    static DominoGroup createRandomGroup(size_t size);
+    static BasicDominoGroup createRandomGroup(size_t size);
+
+    /**
+     * @brief Создает воспроизводимую группу случайных домино, заполняя ее в нескольких потоках.
+     *
+     * Массив делится на блоки фиксированного размера, каждый блок заполняется собственным
+     * потоком DominoRng(seed, номер блока). Поэтому результат зависит только от size и seed,
+     * но не от количества потоков.
+     * @param size Количество домино в группе.
+     * @param seed Зерно генератора.
+     * @param threads Количество потоков (0 — по числу ядер).
+     * @return Группа случайных домино.
+     */
+    static BasicDominoGroup createRandomGroup(size_t size, std::uint64_t seed, unsigned threads = 1);
     /**
      * @brief Генерирует полный набор домино, с указанным количеством повторений для каждой комбинации.
      * @param repeat Количество повторений каждой домино комбинации (по умолчанию 1).
      * @return Полный набор домино.
      */
-    static DominoGroup generateFullSet(int repeat = 1);
+    static BasicDominoGroup generateFullSet(int repeat = 1);
 
     /**
      * @brief Добавляет домино в группу.
      * @param domino Домино, которое нужно добавить.
      * @return Ссылка на текущий объект после добавления.
      */
-    DominoGroup& operator+=(const Domino& domino);
+    BasicDominoGroup& operator+=(const Tile& domino);
+
+    /**
+     * @brief Добавляет в конец группы непрерывный массив домино одним копированием.
+     *
+     * Массив может быть частью самой группы.
+     * @param tiles Добавляемые домино.
+     */
+    void append(std::span<const Tile> tiles);
 
     /**
      * @brief Добавляет случайное домино в группу.
@@ -77,10 +431,56 @@ public:
 
     /**
      * @brief Удаляет и возвращает случайное домино из группы.
+     *
+     * Выбор равномерный (генератор текущего потока), удаление за O(1): на место
+     * выбранного домино переносится последнее, поэтому порядок группы не сохраняется.
      * @return Случайно выбранное домино.
      * @throws std::runtime_error Если группа пуста.
      */
-    Domino getRandomDomino();
+    Tile getRandomDomino();
+
+    /**
+     * @brief Удаляет и возвращает случайное домино, используя заданный генератор.
+     * @tparam Generator Тип, удовлетворяющий UniformRandomBitGenerator.
+     * @param gen Генератор случайных чисел.
+     * @return Случайно выбранное домино.
+     * @throws std::runtime_error Если группа пуста.
+     */
+    template<typename Generator>
+    Tile getRandomDomino(Generator& gen) {
+        DominoScopeTimer timer(DominoOperation::GetRandomDomino);
+        if (count == 0) throw std::runtime_error("Group is empty");
+
+        size_t index = DominoRng::bounded(gen, count);
+        Tile removedDomino = dominoes[index];
+        dominoes[index] = dominoes[--count];
+        onErase(removedDomino);
+        return removedDomino;
+    }
+
+    /**
+     * @brief Раздает руки игрокам из полного набора и возвращает оставшийся базар.
+     *
+     * Выполняется частичное перемешивание Фишера–Йетса только первых players * handSize
+     * позиций полного набора, поэтому раздача занимает один проход.
+     * @param players Количество игроков.
+     * @param handSize Количество домино в руке каждого игрока.
+     * @return Руки игроков и базар.
+     * @throws std::invalid_argument Если в наборе не хватает домино для раздачи.
+     */
+    static BasicDominoDeal<MaxPip> deal(size_t players, size_t handSize);
+
+    /**
+     * @brief Раздает руки игрокам из полного набора, используя заданный генератор.
+     * @tparam Generator Тип, удовлетворяющий UniformRandomBitGenerator.
+     * @param players Количество игроков.
+     * @param handSize Количество домино в руке каждого игрока.
+     * @param gen Генератор случайных чисел.
+     * @return Руки игроков и базар.
+     * @throws std::invalid_argument Если в наборе не хватает домино для раздачи.
+     */
+    template<typename Generator>
+    static BasicDominoDeal<MaxPip> deal(size_t players, size_t handSize, Generator& gen);
     /**
     * @brief Удаляет и возвращает конкретное домино по значениям сторон.
     * @param left Левая сторона домино.
@@ -88,23 +488,112 @@ public:
     * @return Найденное и удаленное домино.
     * @throws std::invalid_argument Если указанного домино не существует.
     */
-    Domino getDomino(int left, int right);
+    Tile getDomino(int left, int right);
 
     /**
-     * @brief Возвращает домино по индексу в группе.
+     * @class TileReference
+     * @brief Изменяемая ссылка на домино группы, которую возвращает неконстантный operator[].
+     *
+     * Хранит копию домино, взятую при обращении, поэтому чтение (getLeft, сравнение, вывод)
+     * работает как у обычного домино. Присваивание, setLeft, setRight и ввод из потока
+     * записываются в группу через setDomino, так что индекс группы остается согласованным.
+     * Ссылка не должна переживать изменение группы другими способами: ее копия устареет.
+     */
+    class TileReference : public Tile {
+        friend class BasicDominoGroup;
+
+        BasicDominoGroup* group; /**< Группа, в которую выполняется запись. */
+        int index;               /**< Индекс домино в группе. */
+
+        TileReference(BasicDominoGroup& group, int index)
+                : Tile(static_cast<const BasicDominoGroup&>(group)[index]), group(&group), index(index) {}
+
+    public:
+        TileReference(const TileReference&) = default;
+
+        /**
+         * @brief Заменяет домино в группе.
+         * @param domino Новое домино.
+         * @return Ссылка на текущий объект.
+         */
+        TileReference& operator=(const Tile& domino) {
+            group->setDomino(index, domino);
+            Tile::operator=(domino);
+            return *this;
+        }
+
+        /**
+         * @brief Заменяет домино в группе домино, на которое указывает другая ссылка.
+         * @param other Ссылка на домино-источник.
+         * @return Ссылка на текущий объект.
+         */
+        TileReference& operator=(const TileReference& other) {
+            return *this = static_cast<const Tile&>(other);
+        }
+
+        /**
+         * @brief Устанавливает левую сторону домино в группе.
+         * @param l Новое значение левой стороны.
+         * @throws std::invalid_argument Если значение не находится в пределах от 0 до MaxPip.
+         */
+        void setLeft(std::uint8_t l) {
+            Tile changed = *this;
+            changed.setLeft(l);
+            *this = changed;
+        }
+
+        /**
+         * @brief Устанавливает правую сторону домино в группе.
+         * @param r Новое значение правой стороны.
+         * @throws std::invalid_argument Если значение не находится в пределах от 0 до MaxPip.
+         */
+        void setRight(std::uint8_t r) {
+            Tile changed = *this;
+            changed.setRight(r);
+            *this = changed;
+        }
+
+        /**
+         * @brief Читает домино из потока прямо в группу.
+         * @param in Входной поток.
+         * @param reference Ссылка на домино группы.
+         * @return Входной поток.
+         */
+        friend std::istream& operator>>(std::istream& in, TileReference&& reference) {
+            Tile read = reference;
+            if (in >> read) reference = read;
+            return in;
+        }
+    };
+
+    /**
+     * @brief Возвращает изменяемую ссылку на домино по индексу в группе.
+     *
+     * Запись через ссылку выполняется методом setDomino и обновляет индекс группы. Для массовых
+     * изменений выгоднее updateTiles, для чтения — константная версия или tiles().
      * @param index Индекс домино в группе.
      * @return Ссылка на домино по заданному индексу.
      * @throws std::out_of_range Если индекс выходит за пределы допустимого диапазона.
      */
-    Domino& operator[](int index);
+    TileReference operator[](int index) {
+        return TileReference(*this, index);
+    }
 
     /**
-    * @brief Константная версия оператора доступа по индексу.
+     * @brief Константная версия оператора доступа по индексу.
      * @param index Индекс домино в группе.
-    * @return Константная ссылка на домино.
+     * @return Константная ссылка на домино.
      * @throws std::out_of_range Если индекс выходит за пределы допустимого диапазона.
-    */
-    const Domino& operator[](int index) const;
+     */
+    const Tile& operator[](int index) const;
+
+    /**
+     * @brief Заменяет домино по индексу, обновляя индекс за O(1).
+     * @param index Индекс домино в группе.
+     * @param domino Новое домино.
+     * @throws std::out_of_range Если индекс выходит за пределы допустимого диапазона.
+     */
+    void setDomino(int index, const Tile& domino);
 
     /**
      * @brief Удаляет и возвращает домино по индексу.
@@ -112,24 +601,331 @@ public:
      * @return Домино по заданному индексу.
      * @throws std::out_of_range Если индекс выходит за пределы допустимого диапазона.
      */
-    Domino getByIndex(int index);
+    Tile getByIndex(int index);
+
+    /**
+     * @brief Удаляет домино по значениям сторон за O(1) после поиска, не сдвигая остальные.
+     *
+     * В отличие от getDomino на место удаленного домино переносится последнее. Вместе с restore
+     * образует пару «ход — отмена хода» для перебора дерева игры на одной группе, без копирования
+     * руки и выделения памяти в каждом узле.
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Запись об удалении для restore.
+     * @throws std::invalid_argument Если указанного домино не существует.
+     */
+    Removal takeDomino(int left, int right);
+
+    /**
+     * @brief Удаляет домино по индексу за O(1), перенося на его место последнее.
+     * @param index Индекс домино в группе.
+     * @return Запись об удалении для restore.
+     * @throws std::out_of_range Если индекс выходит за пределы допустимого диапазона.
+     */
+    Removal takeByIndex(size_t index);
+
+    /**
+     * @brief Отменяет takeDomino или takeByIndex за O(1), восстанавливая прежний порядок домино.
+     *
+     * Отмены должны выполняться в обратном порядке удалений (как в стеке), и между удалением
+     * и его отменой группа не должна изменяться другими способами, кроме парных удалений
+     * и отмен, добавлений и removeLast. Память не выделяется: место освободилось при удалении.
+     * @param removal Запись, возвращенная при удалении.
+     */
+    void restore(const Removal& removal) noexcept;
+
+    /**
+     * @brief Удаляет и возвращает последнее домино за O(1) — отмена operator+=.
+     * @return Удаленное домино.
+     * @throws std::runtime_error Если группа пуста.
+     */
+    Tile removeLast();
 
     /**
      * @brief Сортирует домино в группе по возрастанию суммы значений сторон.
+     *
+     * Используется устойчивая сортировка подсчетом за O(n): ключ принимает не более
+     * (2 * MaxPip + 1) * (MaxPip + 1) * 2 значений, поэтому сравнения не нужны. Домино во
+     * встроенном буфере остаются в нем: до INSERTION_SORT_LIMIT домино они сортируются вставками
+     * без выделения памяти, большие встроенные группы сортируются подсчетом через временный массив.
+     * @param options Дополнительные ключи, направление и количество потоков.
      */
-    void sortDominoes();
+    void sortDominoes(const DominoSortOptions& options = {});
 
     /**
      * @brief Возвращает подгруппу домино с одной из сторон, равной указанному значению.
      * @param value Значение для фильтрации домино.
      * @return Группа домино, у которых одна из сторон равна value.
      */
-    DominoGroup getSubGroup(int value);
+    BasicDominoGroup getSubGroup(int value);
 
     /**
-     * @brief Выводит информацию о группе домино в консоль.
+     * @brief Извлекает из группы все домино, удовлетворяющие предикату, за два линейных прохода.
+     *
+     * Порядок сохраняется и в извлеченной, и в оставшейся части (стабильное разбиение).
+     * Первый проход вызывает предикат и запоминает ответы битовой маской (до 256 домино — на
+     * стеке), затем результат резервируется ровно под извлекаемые домино, и только второй проход
+     * меняет группу. Поэтому при исключении из предиката или при нехватке памяти группа остается
+     * в исходном состоянии (строгая гарантия).
+     * @tparam Predicate Вызываемый объект вида bool(const Tile&).
+     * @param pred Предикат отбора.
+     * @return Группа извлеченных домино.
+     * @throws std::bad_alloc Если не удалось выделить память под маску или результат.
      */
-    void printGroup() const;
+    template<typename Predicate>
+    BasicDominoGroup extractIf(Predicate pred) {
+        DominoScopeTimer timer(DominoOperation::ExtractIf);
+        constexpr size_t LOCAL_WORDS = 4;
+        const size_t words = (count + 63) / 64;
+        std::uint64_t localMask[LOCAL_WORDS] = {};
+        std::pmr::vector<std::uint64_t> heapMask(resource);
+        std::uint64_t* mask = localMask;
+        if (words > LOCAL_WORDS) {
+            heapMask.resize(words);
+            mask = heapMask.data();
+        }
+
+        size_t taken = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (pred(static_cast<const Tile&>(dominoes[i]))) {
+                mask[i / 64] |= std::uint64_t{1} << (i % 64);
+                ++taken;
+            }
+        }
+
+        BasicDominoGroup extracted(resource);
+        extracted.reserve(taken);
+        size_t kept = 0;
+        size_t shifted = 0;
+        for (size_t i = 0; i < count; i++) {
+            if ((mask[i / 64] >> (i % 64)) & 1) {
+                extracted.dominoes[extracted.count++] = dominoes[i];
+                extracted.onInsert(dominoes[i]);
+                onErase(dominoes[i]);
+            } else {
+                shifted += kept != i;
+                dominoes[kept++] = dominoes[i];
+            }
+        }
+        DominoInstrumentation::add(DominoCounter::ElementsShifted, shifted);
+        count = kept;
+        return extracted;
+    }
+
+    /**
+     * @brief Удаляет из группы все домино, удовлетворяющие предикату, за один линейный проход.
+     *
+     * Порядок оставшихся домино сохраняется, память не выделяется. Если предикат выбросит
+     * исключение, группа остается согласованной (базовая гарантия): домино, для которых он уже
+     * вернул true, удалены, все остальные сохранены в прежнем порядке.
+     * @tparam Predicate Вызываемый объект вида bool(const Tile&).
+     * @param pred Предикат отбора.
+     * @return Количество удаленных домино.
+     */
+    template<typename Predicate>
+    size_t eraseIf(Predicate pred) {
+        DominoScopeTimer timer(DominoOperation::EraseIf);
+        size_t kept = 0;
+        size_t shifted = 0;
+        size_t i = 0;
+        try {
+            for (; i < count; i++) {
+                if (!pred(static_cast<const Tile&>(dominoes[i]))) {
+                    shifted += kept != i;
+                    dominoes[kept++] = dominoes[i];
+                } else {
+                    onErase(dominoes[i]);
+                }
+            }
+        } catch (...) {
+            // Непроверенные домино остаются в группе
+            if (kept != i) {
+                shifted += count - i;
+                std::copy(dominoes + i, dominoes + count, dominoes + kept);
+            }
+            DominoInstrumentation::add(DominoCounter::ElementsShifted, shifted);
+            count -= i - kept;
+            throw;
+        }
+        DominoInstrumentation::add(DominoCounter::ElementsShifted, shifted);
+        size_t removed = count - kept;
+        count = kept;
+        return removed;
+    }
+
+    /**
+     * @brief Возвращает количество экземпляров указанного домино за O(1), не изменяя группу.
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Количество экземпляров (ориентация не учитывается); 0 для значений вне диапазона.
+     */
+    size_t countOf(int left, int right) const;
+
+    /**
+     * @brief Возвращает количество домино, у которых одна из сторон равна value, за O(MaxPip).
+     * @param value Значение стороны.
+     * @return Количество домино (дубль считается один раз); 0 для значений вне диапазона.
+     */
+    size_t countWithPip(int value) const;
+
+    /**
+     * @brief Возвращает количество домино, которые можно приставить к концам линии leftEnd и rightEnd.
+     * @param leftEnd Значение на левом конце линии.
+     * @param rightEnd Значение на правом конце линии.
+     * @return Количество подходящих домино в группе, каждое считается один раз.
+     */
+    size_t countPlayable(int leftEnd, int rightEnd) const;
+
+    /**
+     * @brief Перебирает домино, которые можно приставить к концам линии, не копируя и не изменяя группу.
+     *
+     * Просматриваются только 2 * (MaxPip + 1) костей, содержащих leftEnd или rightEnd, поэтому
+     * время не зависит от размера группы. Каждая кость передается один раз в канонической
+     * ориентации (left <= right) вместе с количеством ее экземпляров.
+     * @tparam Visitor Вызываемый объект вида void(const Tile& domino, size_t copies).
+     * @param leftEnd Значение на левом конце линии.
+     * @param rightEnd Значение на правом конце линии.
+     * @param visit Обработчик найденных костей.
+     */
+    template<typename Visitor>
+    void forEachPlayable(int leftEnd, int rightEnd, Visitor visit) const {
+        auto visitPip = [&](int value, int skip) {
+            if (value < 0 || value > MaxPip) return;
+            for (int other = 0; other <= MaxPip; other++) {
+                if (other == skip) continue;
+                size_t index = Tables::tilesWithPip[value][other];
+                if (tileCounts[index] > 0) visit(Tables::fullSet[index], tileCounts[index]);
+            }
+        };
+        visitPip(leftEnd, -1);
+        if (rightEnd != leftEnd) visitPip(rightEnd, leftEnd);
+    }
+
+    /**
+     * @brief Возвращает множество различных костей группы.
+     * @return Маска, в которой отмечены кости, присутствующие хотя бы в одном экземпляре.
+     */
+    typename Tables::TileMask tileMask() const;
+
+    /**
+     * @brief Вычисляет сумму значений, количество сторон с каждым значением, число дублей
+     * и гистограмму сумм сторон.
+     *
+     * Вся статистика выводится из индекса за O(TILE_COUNT), массив не просматривается.
+     * @return Статистика группы.
+     */
+    BasicDominoStatistics<MaxPip> statistics() const;
+
+    /**
+     * @brief Возвращает хеш группы, не зависящий от порядка и ориентации домино.
+     *
+     * Хеш Зобриста (сумма ключей BasicDominoTables::zobrist) поддерживается вместе с индексом
+     * при каждом добавлении и удалении, поэтому запрос выполняется за O(1). Группы с
+     * sameTiles() == true имеют равные хеши; это позволяет хранить руки в таблицах
+     * транспозиций.
+     * @return 64-битный хеш.
+     */
+    std::uint64_t hash() const;
+
+    /**
+     * @brief Проверяет, что группы состоят из одних и тех же костей с учетом повторений.
+     *
+     * Порядок и ориентация домино не учитываются; сравниваются счетчики индекса, поэтому
+     * время не зависит от размера групп.
+     * @param other Другая группа.
+     * @return true, если каждая кость входит в обе группы одинаковое число раз.
+     */
+    bool sameTiles(const BasicDominoGroup& other) const;
+
+    /**
+     * @brief Проверяет, что каждая кость группы входит в other не меньшее число раз.
+     * @param other Другая группа.
+     * @return true, если группа — подмножество other (с учетом повторений).
+     */
+    bool isSubsetOf(const BasicDominoGroup& other) const;
+
+    /**
+     * @brief Объединение: каждая кость входит наибольшее из двух количеств раз.
+     * @param other Другая группа.
+     * @return Новая группа в каноническом порядке и ориентации.
+     */
+    BasicDominoGroup setUnion(const BasicDominoGroup& other) const;
+
+    /**
+     * @brief Пересечение: каждая кость входит наименьшее из двух количеств раз.
+     * @param other Другая группа.
+     * @return Новая группа в каноническом порядке и ориентации.
+     */
+    BasicDominoGroup setIntersection(const BasicDominoGroup& other) const;
+
+    /**
+     * @brief Разность: из количества каждой кости вычитается ее количество в other (не меньше нуля).
+     *
+     * Например, еще не вышедшие кости — generateFullSet().setDifference(hand).setDifference(played).
+     * @param other Вычитаемая группа.
+     * @return Новая группа в каноническом порядке и ориентации.
+     */
+    BasicDominoGroup setDifference(const BasicDominoGroup& other) const;
+
+    /**
+     * @brief Выводит изображения домино группы в поток.
+     *
+     * Изображение собирается кусками в буфер и записывается в поток целиком, без сброса
+     * после каждой строки. При perRow == 1 вывод совпадает с построчным вертикальным форматом.
+     * @param out Выходной поток (по умолчанию консоль).
+     * @param perRow Количество домино, рисуемых рядом в одном ряду.
+     */
+    void printGroup(std::ostream& out = std::cout, size_t perRow = 1) const;
+
+    /**
+     * @brief Возвращает размер изображения группы в байтах.
+     * @param perRow Количество домино в одном ряду.
+     * @return Количество байт, которое запишет render.
+     */
+    size_t renderedSize(size_t perRow = 1) const;
+
+    /**
+     * @brief Рисует изображение группы в строку.
+     * @param perRow Количество домино в одном ряду.
+     * @return Изображение группы (тот же текст, что выводит printGroup).
+     */
+    std::string render(size_t perRow = 1) const;
+
+    /**
+     * @brief Рисует изображение группы в буфер вызывающей стороны.
+     * @param buffer Буфер для записи.
+     * @param bufferSize Размер буфера в байтах.
+     * @param perRow Количество домино в одном ряду.
+     * @return Требуемый размер; если он больше bufferSize, буфер не изменяется.
+     */
+    size_t render(char* buffer, size_t bufferSize, size_t perRow = 1) const;
+
+    /**
+     * @brief Возвращает размер текстового представления группы (как у operator<<) в байтах.
+     * @return Количество байт, которое запишет format.
+     */
+    size_t formattedSize() const noexcept;
+
+    /**
+     * @brief Возвращает текст группы "(l|r) (l|r) ... " — тот же, что выводит operator<<.
+     * @return Текст группы.
+     */
+    std::string format() const;
+
+    /**
+     * @brief Записывает текст группы в буфер вызывающей стороны.
+     * @param buffer Буфер для записи.
+     * @param bufferSize Размер буфера в байтах.
+     * @return Требуемый размер; если он больше bufferSize, буфер не изменяется.
+     */
+    size_t format(char* buffer, size_t bufferSize) const noexcept;
+
+    /**
+     * @brief Записывает текст группы в файловый дескриптор кусками, минуя iostream.
+     * @param fd Открытый для записи файловый дескриптор.
+     * @throws std::runtime_error Если запись не удалась.
+     */
+    void writeText(int fd) const;
 
     /**
      * @brief Возвращает количество домино в группе.
@@ -137,27 +933,348 @@ public:
      */
     size_t size() const;
 
+    /**
+     * @brief Сохраняет группу в компактном двоичном формате (см. DominoFileHeader).
+     *
+     * В формате Codes домино перекодируются кусками по байту на домино и записываются крупными
+     * блоками; в формате Histogram записываются только счетчики индекса, размер файла не
+     * зависит от размера группы.
+     * @param out Выходной поток (должен быть открыт в двоичном режиме).
+     * @param encoding Способ кодирования.
+     */
+    void save(std::ostream& out, DominoEncoding encoding = DominoEncoding::Codes) const;
+
+    /**
+     * @brief Загружает группу, сохраненную save.
+     *
+     * Группа из файла Histogram восстанавливается в каноническом порядке и ориентации.
+     * @param in Входной поток (должен быть открыт в двоичном режиме).
+     * @return Загруженная группа.
+     * @throws std::runtime_error Если данные повреждены, обрезаны или записаны для другого диапазона значений.
+     */
+    static BasicDominoGroup load(std::istream& in);
+
+    /**
+     * @brief Проверяет, пуста ли группа.
+     * @return true, если в группе нет домино.
+     */
+    bool empty() const noexcept {
+        return count == 0;
+    }
+
+    /**
+     * @brief Итератор на первое домино.
+     *
+     * Группа — непрерывный диапазон (std::ranges::contiguous_range) только для чтения: ее можно
+     * обходить range-for, передавать в std::ranges-алгоритмы и ленивые представления DominoViews
+     * без копирования. Проверка границ, как в operator[], не выполняется.
+     * @return Указатель на первое домино.
+     */
+    const_iterator begin() const noexcept {
+        return dominoes;
+    }
+
+    /**
+     * @brief Итератор за последним домино.
+     * @return Указатель на позицию за последним домино.
+     */
+    const_iterator end() const noexcept {
+        return dominoes + count;
+    }
+
+    /**
+     * @brief Указатель на непрерывный массив домино.
+     * @return Указатель на первое домино (nullptr для группы без памяти).
+     */
+    const Tile* data() const noexcept {
+        return dominoes;
+    }
+
+    /**
+     * @brief Возвращает домино группы как std::span только для чтения.
+     * @return Представление массива домино без копирования.
+     */
+    std::span<const Tile> tiles() const noexcept {
+        return {dominoes, count};
+    }
+
+    /**
+     * @brief Дает изменить домино на месте через std::span (например, std::ranges::sort) и пересчитывает индекс.
+     *
+     * Индекс пересчитывается одним проходом после возврата из update, в том числе если update
+     * бросил исключение; для больших групп проход делится между threads потоками.
+     * @tparam Function Вызываемый объект вида void(std::span<Tile> tiles).
+     * @param update Функция, изменяющая домино.
+     * @param threads Количество потоков для пересчета индекса (0 — по числу ядер).
+     */
+    template<typename Function>
+    void updateTiles(Function&& update, unsigned threads = 1) {
+        try {
+            update(std::span<Tile>(dominoes, count));
+        } catch (...) {
+            rebuildIndex(threads);
+            throw;
+        }
+        rebuildIndex(threads);
+    }
+
     /**
      * @brief Оператор присваивания для копирования группы домино.
+     *
+     * Если вместимости хватает, память не перераспределяется. Источник памяти не меняется.
      * @param other Другая группа домино.
      * @return Ссылка на текущий объект.
      */
-    DominoGroup& operator=(const DominoGroup& other);
+    BasicDominoGroup& operator=(const BasicDominoGroup& other);
+
+    /**
+     * @brief Оператор перемещающего присваивания.
+     *
+     * Забирает массив вместе с источником памяти other, поэтому не копирует домино. Исключение —
+     * встроенный буфер: если домино помещаются во встроенный буфер этой группы, они копируются в
+     * него, а массив other освобождается. Домино из встроенного буфера other копируются и могут
+     * потребовать выделения памяти, поэтому оператор не объявлен noexcept.
+     * @param other Перемещаемая группа.
+     * @return Ссылка на текущий объект.
+     * @throws std::bad_alloc Только если other — встроенная группа, ее домино не помещаются в эту
+     *         группу и не удалось выделить память.
+     */
+    BasicDominoGroup& operator=(BasicDominoGroup&& other);
+
+    /**
+     * @brief Перемещающее присваивание встроенной группы.
+     * @param other Перемещаемая группа.
+     * @return Ссылка на текущий объект.
+     * @throws std::bad_alloc Если не удалось выделить память под домино из встроенного буфера.
+     */
+    template<size_t N>
+    BasicDominoGroup& operator=(BasicInlineDominoGroup<MaxPip, N>&& other) {
+        takeTiles(other);
+        return *this;
+    }
 
     /**
      * @brief Перегруженный оператор ввода группы домино из потока.
+     *
+     * Читает количество и затем пары значений. Группа заменяется только после успешного
+     * чтения всех домино; при ошибке она не изменяется. Для больших объемов текста
+     * следует использовать DominoTextParser.
      * @param in Входной поток.
      * @param group Группа домино.
      * @return Входной поток.
      */
-    friend std::istream& operator>>(std::istream& in, DominoGroup& group);
+    template<int P>
+    friend std::istream& operator>>(std::istream& in, BasicDominoGroup<P>& group);
     /**
      * @brief Перегруженный оператор вывода группы домино в поток.
+     *
+     * Текст собирается кусками из таблицы BasicDominoTables::text и записывается в поток
+     * крупными блоками, без форматированного вывода каждого числа.
      * @param out Выходной поток.
      * @param group Группа домино.
      * @return Выходной поток.
      */
-    friend std::ostream& operator<<(std::ostream& out, const DominoGroup& group);
+    template<int P>
+    friend std::ostream& operator<<(std::ostream& out, const BasicDominoGroup<P>& group);
+};
+
+template<int MaxPip>
+void swap(BasicDominoGroup<MaxPip>& a, BasicDominoGroup<MaxPip>& b);
+
+template<int MaxPip>
+std::istream& operator>>(std::istream& in, BasicDominoGroup<MaxPip>& group);
+
+template<int MaxPip>
+std::ostream& operator<<(std::ostream& out, const BasicDominoGroup<MaxPip>& group);
+
+/**
+ * @brief Хеш группы домино по ее составу, см. BasicDominoGroup::hash.
+ *
+ * Равенство для неупорядоченных контейнеров задается отдельно, например через sameTiles.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+struct std::hash<BasicDominoGroup<MaxPip>> {
+    size_t operator()(const BasicDominoGroup<MaxPip>& group) const noexcept {
+        return static_cast<size_t>(group.hash());
+    }
+};
+
+/**
+ * @struct BasicDominoDeal
+ * @brief Результат раздачи: руки игроков и оставшийся базар.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+struct BasicDominoDeal {
+    std::vector<BasicDominoGroup<MaxPip>> hands; /**< Руки игроков в порядке раздачи. */
+    BasicDominoGroup<MaxPip> boneyard;           /**< Домино, оставшиеся после раздачи. */
+};
+
+template<int MaxPip>
+template<typename Generator>
+BasicDominoDeal<MaxPip> BasicDominoGroup<MaxPip>::deal(size_t players, size_t handSize, Generator& gen) {
+    DominoScopeTimer timer(DominoOperation::Deal);
+    BasicDominoGroup set = generateFullSet();
+    size_t dealt = players * handSize;
+    if (dealt > set.count) {
+        throw std::invalid_argument("Not enough dominoes to deal");
+    }
+
+    for (size_t i = 0; i < dealt; i++) {
+        size_t j = i + DominoRng::bounded(gen, set.count - i);
+        std::swap(set.dominoes[i], set.dominoes[j]);
+    }
+
+    BasicDominoDeal<MaxPip> result;
+    result.hands.resize(players);
+    for (size_t p = 0; p < players; p++) {
+        BasicDominoGroup& hand = result.hands[p];
+        hand.reserve(handSize);
+        std::copy(set.dominoes + p * handSize, set.dominoes + (p + 1) * handSize, hand.dominoes);
+        hand.count = handSize;
+        for (size_t i = 0; i < handSize; i++) {
+            hand.onInsert(hand.dominoes[i]);
+            set.onErase(hand.dominoes[i]);
+        }
+    }
+    std::copy(set.dominoes + dealt, set.dominoes + set.count, set.dominoes);
+    set.count -= dealt;
+    result.boneyard = std::move(set);
+    return result;
+}
+
+/**
+ * @class BasicInlineDominoGroup
+ * @brief Группа домино со встроенным буфером на N домино.
+ *
+ * Пока в группе не больше N домино, они хранятся внутри объекта, поэтому создание, заполнение
+ * и уничтожение руки игрока не выделяют память. При росте сверх N массив переносится в источник
+ * памяти, как у обычной группы, а shrinkToFit возвращает домино в буфер. Все операции унаследованы
+ * от BasicDominoGroup, и встроенную группу можно передавать туда, где ожидается BasicDominoGroup&.
+ * Для набора 0..6 доступно имя InlineDominoGroup<N>.
+ * @tparam MaxPip Наибольшее значение стороны.
+ * @tparam N Вместимость встроенного буфера (по умолчанию — полный набор).
+ */
+template<int MaxPip, size_t N>
+class BasicInlineDominoGroup : public BasicDominoGroup<MaxPip> {
+    static_assert(N > 0, "Inline buffer must hold at least one domino");
+    using Base = BasicDominoGroup<MaxPip>;
+
+public:
+    using Tile = BasicDomino<MaxPip>;         /**< Тип домино группы. */
+    static constexpr size_t INLINE_CAPACITY = N; /**< Вместимость встроенного буфера. */
+
+    /**
+     * @brief Создает пустую группу; память для роста сверх N берется из источника по умолчанию.
+     */
+    BasicInlineDominoGroup() noexcept : BasicInlineDominoGroup(std::pmr::get_default_resource()) {}
+
+    /**
+     * @brief Создает пустую группу с указанным источником памяти для роста сверх N.
+     * @param resource Источник памяти; должен жить дольше группы.
+     */
+    explicit BasicInlineDominoGroup(std::pmr::memory_resource* resource) noexcept
+            : Base(reinterpret_cast<Tile*>(storage), N, resource) {}
+
+    /**
+     * @brief Конструктор, принимающий список инициализации.
+     * @param initList Список домино для инициализации группы.
+     */
+    BasicInlineDominoGroup(std::initializer_list<Tile> initList) : BasicInlineDominoGroup() {
+        this->append(std::span<const Tile>(initList.begin(), initList.size()));
+    }
+
+    /**
+     * @brief Копирует любую группу; до N домино копируются во встроенный буфер.
+     * @param other Группа домино для копирования.
+     */
+    BasicInlineDominoGroup(const Base& other) : BasicInlineDominoGroup() {
+        Base::operator=(other);
+    }
+
+    /**
+     * @brief Конструктор копирования.
+     * @param other Группа домино для копирования.
+     */
+    BasicInlineDominoGroup(const BasicInlineDominoGroup& other) : BasicInlineDominoGroup() {
+        Base::operator=(other);
+    }
+
+    /**
+     * @brief Перемещает любую группу: до N домино копируются во встроенный буфер, больший динамический массив забирается.
+     * @param other Перемещаемая группа.
+     * @throws std::bad_alloc Если other — встроенная группа с большим буфером и ее домино не помещаются в N.
+     */
+    BasicInlineDominoGroup(Base&& other) : BasicInlineDominoGroup() {
+        if (this != &other) this->takeTiles(other);
+    }
+
+    /**
+     * @brief Конструктор перемещения; домино из буфера other помещаются в буфер, поэтому память не выделяется.
+     * @param other Перемещаемая группа.
+     */
+    BasicInlineDominoGroup(BasicInlineDominoGroup&& other) noexcept : BasicInlineDominoGroup() {
+        Base::operator=(std::move(other));
+    }
+
+    /**
+     * @brief Копирующее присваивание любой группы.
+     * @param other Группа домино для копирования.
+     * @return Ссылка на текущий объект.
+     */
+    BasicInlineDominoGroup& operator=(const Base& other) {
+        Base::operator=(other);
+        return *this;
+    }
+
+    /**
+     * @brief Копирующее присваивание.
+     * @param other Группа домино для копирования.
+     * @return Ссылка на текущий объект.
+     */
+    BasicInlineDominoGroup& operator=(const BasicInlineDominoGroup& other) {
+        Base::operator=(other);
+        return *this;
+    }
+
+    /**
+     * @brief Перемещающее присваивание любой группы.
+     * @param other Перемещаемая группа.
+     * @return Ссылка на текущий объект.
+     * @throws std::bad_alloc Если other — встроенная группа с большим буфером и ее домино не помещаются в N.
+     */
+    BasicInlineDominoGroup& operator=(Base&& other) {
+        if (this != &other) this->takeTiles(other);
+        return *this;
+    }
+
+    /**
+     * @brief Перемещающее присваивание; память не выделяется.
+     * @param other Перемещаемая группа.
+     * @return Ссылка на текущий объект.
+     */
+    BasicInlineDominoGroup& operator=(BasicInlineDominoGroup&& other) noexcept {
+        Base::operator=(std::move(other));
+        return *this;
+    }
+
+private:
+    alignas(Tile) unsigned char storage[N * sizeof(Tile)]; /**< Встроенный буфер; домино создаются в нем копированием. */
 };
 
+extern template class BasicDominoGroup<6>;
+extern template class BasicDominoGroup<9>;
+extern template class BasicDominoGroup<12>;
+extern template class BasicDominoGroup<15>;
+
+using DominoGroup = BasicDominoGroup<6>;    /**< Группа классических домино 0..6. */
+using DominoGroup9 = BasicDominoGroup<9>;   /**< Группа домино 0..9. */
+using DominoGroup12 = BasicDominoGroup<12>; /**< Группа домино 0..12. */
+using DominoGroup15 = BasicDominoGroup<15>; /**< Группа домино 0..15. */
+template<size_t N = BasicDominoTables<6>::TILE_COUNT>
+using InlineDominoGroup = BasicInlineDominoGroup<6, N>; /**< Группа классических домино со встроенным буфером на N домино. */
+using DominoDeal = BasicDominoDeal<6>;      /**< Раздача классического набора. */
+using DominoStatistics = BasicDominoStatistics<6>; /**< Статистика группы классических домино 0..6. */
+
 #endif
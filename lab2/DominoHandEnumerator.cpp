@@ -0,0 +1,85 @@
+#include "DominoHandEnumerator.h"
+#include <stdexcept>
+
+template<int MaxPip>
+BasicDominoHandEnumerator<MaxPip>::BasicDominoHandEnumerator(size_t handSize)
+        : BasicDominoHandEnumerator(typename Tables::TileMask().set(), handSize) {}
+
+template<int MaxPip>
+BasicDominoHandEnumerator<MaxPip>::BasicDominoHandEnumerator(const typename Tables::TileMask& pool, size_t handSize)
+        : pool(pool.to_ullong()), poolSize(pool.count()), hand(handSize), contiguous(false) {
+    if (handSize > poolSize) {
+        throw std::invalid_argument("Not enough dominoes for a hand");
+    }
+    contiguous = this->pool == (poolSize == 64 ? ~Mask(0) : (Mask(1) << poolSize) - 1);
+    if (contiguous) return;
+
+    // j-я кость множества — j-й установленный бит pool; таблица на каждый байт номеров
+    std::vector<Mask> bits;
+    for (Mask rest = this->pool; rest != 0; rest &= rest - 1) {
+        bits.push_back(rest & -rest);
+    }
+    deposit.resize((poolSize + 7) / 8);
+    for (size_t byte = 0; byte < deposit.size(); byte++) {
+        for (size_t value = 0; value < 256; value++) {
+            Mask mask = 0;
+            for (size_t bit = 0; bit < 8 && byte * 8 + bit < poolSize; bit++) {
+                if (value & (size_t(1) << bit)) mask |= bits[byte * 8 + bit];
+            }
+            deposit[byte][value] = mask;
+        }
+    }
+}
+
+template<int MaxPip>
+BasicDominoHandEnumerator<MaxPip>::BasicDominoHandEnumerator(const BasicDominoGroup<MaxPip>& pool, size_t handSize)
+        : BasicDominoHandEnumerator([&pool] {
+            typename Tables::TileMask mask = pool.tileMask();
+            if (mask.count() != pool.size()) {
+                throw std::invalid_argument("Hand pool must not repeat dominoes");
+            }
+            return mask;
+        }(), handSize) {}
+
+template<int MaxPip>
+typename BasicDominoHandEnumerator<MaxPip>::Mask BasicDominoHandEnumerator<MaxPip>::unrankCompact(std::uint64_t rank) const noexcept {
+    // Комбинаторная система счисления: номер = C(c_k, k) + ... + C(c_1, 1), c_k > ... > c_1
+    Mask compact = 0;
+    size_t top = poolSize;
+    for (size_t k = hand; k > 0; k--) {
+        size_t c = top - 1;
+        while (binomials[c][k] > rank) --c;
+        compact |= Mask(1) << c;
+        rank -= binomials[c][k];
+        top = c;
+    }
+    return compact;
+}
+
+template<int MaxPip>
+typename BasicDominoHandEnumerator<MaxPip>::Mask BasicDominoHandEnumerator<MaxPip>::unrank(std::uint64_t rank) const {
+    if (rank >= size()) {
+        throw std::out_of_range("Invalid hand rank");
+    }
+    Mask compact = unrankCompact(rank);
+    return contiguous ? compact : expand(compact);
+}
+
+template<int MaxPip>
+BasicDominoGroup<MaxPip> BasicDominoHandEnumerator<MaxPip>::toGroup(Mask hand) {
+    BasicDominoGroup<MaxPip> group;
+    toGroup(hand, group);
+    return group;
+}
+
+template<int MaxPip>
+void BasicDominoHandEnumerator<MaxPip>::toGroup(Mask hand, BasicDominoGroup<MaxPip>& group) {
+    group.clear();
+    group.reserve(static_cast<size_t>(std::popcount(hand)));
+    for (; hand != 0; hand &= hand - 1) {
+        group += Tables::fullSet[std::countr_zero(hand)];
+    }
+}
+
+template class BasicDominoHandEnumerator<6>;
+template class BasicDominoHandEnumerator<9>;
@@ -0,0 +1,255 @@
+#ifndef DOMINOHANDENUMERATOR_H
+#define DOMINOHANDENUMERATOR_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "Domino.h"
+#include "DominoGroup.h"
+#include "DominoTables.h"
+
+/**
+ * @class BasicDominoHandEnumerator
+ * @brief Перебор всех рук из handSize домино, которые можно взять из заданного множества костей.
+ *
+ * Рука — маска в одном 64-битном слове: бит i соответствует кости Tables::fullSet[i], как в
+ * BasicDominoTables::TileMask. Сочетания перебираются в порядке возрастания маски приемом
+ * Госпера (следующее сочетание — несколько битовых операций без ветвлений), поэтому полный
+ * перебор 1 184 040 рук по 7 домино из 28 не выделяет память и не строит групп.
+ *
+ * Если множество костей — не полный набор (например, кости, которых игрок еще не видел),
+ * сочетания перебираются по номерам костей множества, а маска руки получается подстановкой
+ * номеров в биты костей по таблицам на каждый байт. Каждое сочетание имеет номер в том же
+ * порядке; unrank восстанавливает сочетание по номеру, что позволяет делить перебор между
+ * потоками на равные непрерывные диапазоны.
+ *
+ * Маска в одно слово ограничивает набор 64 костями, поэтому перебор доступен для наборов
+ * 0..6 и 0..9. Для набора 0..6 доступно имя DominoHandEnumerator.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+class BasicDominoHandEnumerator {
+public:
+    using Tile = BasicDomino<MaxPip>;         /**< Тип домино набора. */
+    using Tables = BasicDominoTables<MaxPip>; /**< Таблицы набора. */
+    using Mask = std::uint64_t;               /**< Рука или множество костей: бит i — кость Tables::fullSet[i]. */
+
+    static_assert(Tables::TILE_COUNT <= 64, "Hand masks hold at most 64 distinct dominoes");
+
+    static constexpr size_t PARALLEL_CHUNK = 1 << 16; /**< Минимальное количество рук на поток. */
+
+private:
+    /**
+     * @brief Биномиальные коэффициенты C(n, k) для n, k <= 64.
+     */
+    static constexpr auto binomials = [] {
+        std::array<std::array<std::uint64_t, 65>, 65> table{};
+        for (size_t n = 0; n <= 64; n++) {
+            table[n][0] = 1;
+            for (size_t k = 1; k <= n; k++) {
+                table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0);
+            }
+        }
+        return table;
+    }();
+
+    Mask pool;             /**< Множество костей, из которого берутся руки. */
+    size_t poolSize;       /**< Количество костей в множестве. */
+    size_t hand;           /**< Количество домино в руке. */
+    bool contiguous;       /**< Множество — младшие poolSize бит, подстановка номеров не нужна. */
+    std::vector<std::array<Mask, 256>> deposit; /**< Для каждого байта номеров: маска костей по значению байта. */
+
+    /**
+     * @brief Следующее сочетание с тем же количеством бит (прием Госпера без деления).
+     * @param x Текущее сочетание; не должно быть последним.
+     * @return Наименьшая большая маска с тем же количеством бит.
+     */
+    static Mask nextCombination(Mask x) noexcept {
+        Mask t = x | (x - 1);
+        return (t + 1) | (((~t & -~t) - 1) >> (std::countr_zero(x) + 1));
+    }
+
+    /**
+     * @brief Переводит сочетание номеров костей множества в маску костей.
+     * @param compact Сочетание: бит j — j-я по порядку кость множества.
+     * @return Маска руки.
+     */
+    Mask expand(Mask compact) const noexcept {
+        Mask result = 0;
+        for (size_t byte = 0; compact != 0; byte++, compact >>= 8) {
+            result |= deposit[byte][compact & 0xFF];
+        }
+        return result;
+    }
+
+    /**
+     * @brief Восстанавливает сочетание номеров костей множества по его номеру.
+     * @param rank Номер сочетания (меньше size()).
+     * @return Сочетание номеров.
+     */
+    Mask unrankCompact(std::uint64_t rank) const noexcept;
+
+    /**
+     * @brief Вызывает visitor для count сочетаний, начиная с compact.
+     */
+    template<typename Visitor, typename Expand>
+    static void visitRange(Mask compact, std::uint64_t count, Visitor& visitor, Expand expandMask) {
+        for (;;) {
+            visitor(expandMask(compact));
+            if (--count == 0) return;
+            compact = nextCombination(compact);
+        }
+    }
+
+public:
+    /**
+     * @brief Перебор рук из полного набора.
+     * @param handSize Количество домино в руке.
+     * @throws std::invalid_argument Если в наборе меньше handSize домино.
+     */
+    explicit BasicDominoHandEnumerator(size_t handSize);
+
+    /**
+     * @brief Перебор рук из заданного множества костей.
+     * @param pool Множество костей.
+     * @param handSize Количество домино в руке.
+     * @throws std::invalid_argument Если в множестве меньше handSize костей.
+     */
+    BasicDominoHandEnumerator(const typename Tables::TileMask& pool, size_t handSize);
+
+    /**
+     * @brief Перебор рук из домино группы.
+     * @param pool Группа без повторяющихся костей (ориентация не учитывается).
+     * @param handSize Количество домино в руке.
+     * @throws std::invalid_argument Если кость в группе повторяется или домино меньше handSize.
+     */
+    BasicDominoHandEnumerator(const BasicDominoGroup<MaxPip>& pool, size_t handSize);
+
+    /**
+     * @brief Возвращает количество рук C(poolSize, handSize).
+     * @return Количество сочетаний.
+     */
+    std::uint64_t size() const noexcept {
+        return binomials[poolSize][hand];
+    }
+
+    /**
+     * @brief Возвращает количество домино в руке.
+     * @return Размер руки.
+     */
+    size_t handSize() const noexcept {
+        return hand;
+    }
+
+    /**
+     * @brief Возвращает множество костей, из которого берутся руки.
+     * @return Маска множества.
+     */
+    Mask poolMask() const noexcept {
+        return pool;
+    }
+
+    /**
+     * @brief Возвращает руку с указанным номером в порядке перебора.
+     * @param rank Номер руки (0..size() - 1).
+     * @return Маска руки.
+     * @throws std::out_of_range Если номер не меньше size().
+     */
+    Mask unrank(std::uint64_t rank) const;
+
+    /**
+     * @brief Вызывает visitor(Mask) для каждой руки в порядке перебора.
+     * @tparam Visitor Вызываемый объект, принимающий Mask.
+     * @param visitor Обработчик руки.
+     */
+    template<typename Visitor>
+    void forEach(Visitor&& visitor) const {
+        forEach(0, size(), visitor);
+    }
+
+    /**
+     * @brief Вызывает visitor(Mask) для рук с номерами [first, last).
+     * @tparam Visitor Вызываемый объект, принимающий Mask.
+     * @param first Номер первой руки.
+     * @param last Номер после последней руки (обрезается до size()).
+     * @param visitor Обработчик руки.
+     */
+    template<typename Visitor>
+    void forEach(std::uint64_t first, std::uint64_t last, Visitor&& visitor) const {
+        last = std::min(last, size());
+        if (first >= last) return;
+        Mask compact = unrankCompact(first);
+        if (contiguous) {
+            visitRange(compact, last - first, visitor, [](Mask mask) { return mask; });
+        } else {
+            visitRange(compact, last - first, visitor, [this](Mask mask) { return expand(mask); });
+        }
+    }
+
+    /**
+     * @brief Перебирает руки в нескольких потоках.
+     *
+     * Номера рук делятся на равные непрерывные диапазоны; каждый поток обходит свой диапазон
+     * собственной копией visitor, поэтому накопление внутри visitor не требует синхронизации.
+     * Копии возвращаются в порядке диапазонов, и результат их объединения не зависит от
+     * количества потоков, если объединение ассоциативно.
+     * @tparam Visitor Копируемый вызываемый объект, принимающий Mask.
+     * @param visitor Исходный обработчик, копируемый в каждый поток.
+     * @param threads Количество потоков (0 — по числу ядер).
+     * @return Копии visitor после обхода, по одной на поток.
+     */
+    template<typename Visitor>
+    std::vector<Visitor> forEachParallel(const Visitor& visitor, unsigned threads = 0) const {
+        std::uint64_t total = size();
+        size_t workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+        workers = std::clamp<size_t>(std::min<std::uint64_t>(workers, total / PARALLEL_CHUNK), 1, 64);
+
+        std::vector<Visitor> results(workers, visitor);
+        std::uint64_t chunk = (total + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < workers; t++) {
+            pool.emplace_back([this, &results, t, chunk] {
+                forEach(t * chunk, (t + 1) * chunk, results[t]);
+            });
+        }
+        forEach(0, chunk, results[0]);
+        for (auto& thread : pool) thread.join();
+        return results;
+    }
+
+    /**
+     * @brief Переводит маску руки в множество костей.
+     * @param hand Маска руки.
+     * @return Множество костей.
+     */
+    static typename Tables::TileMask toTileMask(Mask hand) noexcept {
+        return typename Tables::TileMask(hand);
+    }
+
+    /**
+     * @brief Строит группу из руки: кости в каноническом порядке и ориентации.
+     * @param hand Маска руки.
+     * @return Группа домино.
+     */
+    static BasicDominoGroup<MaxPip> toGroup(Mask hand);
+
+    /**
+     * @brief Заполняет группу костями руки, заменяя ее содержимое.
+     *
+     * Удобно для повторного использования одной группы (например, BasicInlineDominoGroup)
+     * при переборе без выделения памяти.
+     * @param hand Маска руки.
+     * @param group Заполняемая группа.
+     */
+    static void toGroup(Mask hand, BasicDominoGroup<MaxPip>& group);
+};
+
+extern template class BasicDominoHandEnumerator<6>;
+extern template class BasicDominoHandEnumerator<9>;
+
+using DominoHandEnumerator = BasicDominoHandEnumerator<6>; /**< Перебор рук классического набора 0..6. */
+
+#endif
@@ -0,0 +1,178 @@
+#include "DominoHistogram.h"
+#include <algorithm>
+#include <stdexcept>
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip>::BasicDominoHistogram() noexcept : counts{}, total(0) {}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip>::BasicDominoHistogram(std::initializer_list<Tile> initList) : counts{}, total(0) {
+    for (const auto& d : initList) {
+        *this += d;
+    }
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip>::BasicDominoHistogram(const BasicDominoGroup<MaxPip>& group) : counts{}, total(group.size()) {
+    // Индекс группы уже хранит количество каждой кости: домино перебирать не нужно
+    for (size_t index = 0; index < TILE_COUNT; index++) {
+        const Tile& tile = Tables::fullSet[index];
+        counts[index] = group.countOf(tile.getLeft(), tile.getRight());
+    }
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip> BasicDominoHistogram<MaxPip>::generateFullSet(int repeat) {
+    BasicDominoHistogram group;
+    if (repeat <= 0) return group;
+    group.counts.fill(static_cast<size_t>(repeat));
+    group.total = TILE_COUNT * static_cast<size_t>(repeat);
+    return group;
+}
+
+template<int MaxPip>
+size_t BasicDominoHistogram<MaxPip>::indexOf(int left, int right) {
+    if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) {
+        throw std::invalid_argument("Values should be between 0 and " + std::to_string(MaxPip));
+    }
+    return Tables::canonical(left, right);
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip>& BasicDominoHistogram<MaxPip>::operator+=(const Tile& domino) {
+    ++counts[Tables::canonicalIndex[domino.code()]];
+    ++total;
+    return *this;
+}
+
+template<int MaxPip>
+BasicDomino<MaxPip> BasicDominoHistogram<MaxPip>::getDomino(int left, int right) {
+    if (left < 0 || left > MaxPip || right < 0 || right > MaxPip) {
+        throw std::invalid_argument("Specified domino not found");
+    }
+    size_t& c = counts[indexOf(left, right)];
+    if (c == 0) {
+        throw std::invalid_argument("Specified domino not found");
+    }
+    --c;
+    --total;
+    return {static_cast<std::uint8_t>(left), static_cast<std::uint8_t>(right)};
+}
+
+template<int MaxPip>
+size_t BasicDominoHistogram<MaxPip>::count(int left, int right) const {
+    return counts[indexOf(left, right)];
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip> BasicDominoHistogram<MaxPip>::getSubGroup(int value) {
+    BasicDominoHistogram subgroup;
+    if (value < 0 || value > MaxPip) return subgroup;
+    for (size_t index : Tables::tilesWithPip[value]) {
+        subgroup.counts[index] = counts[index];
+        subgroup.total += counts[index];
+        total -= counts[index];
+        counts[index] = 0;
+    }
+    return subgroup;
+}
+
+template<int MaxPip>
+typename BasicDominoTables<MaxPip>::TileMask BasicDominoHistogram<MaxPip>::tileMask() const {
+    if constexpr (TILE_COUNT <= 64) {
+        // Маска помещается в одно слово: собираем ее без обращений к отдельным битам bitset
+        unsigned long long bits = 0;
+        for (size_t index = 0; index < TILE_COUNT; index++) {
+            bits |= static_cast<unsigned long long>(counts[index] > 0) << index;
+        }
+        return typename Tables::TileMask(bits);
+    } else {
+        typename Tables::TileMask mask;
+        for (size_t index = 0; index < TILE_COUNT; index++) {
+            mask[index] = counts[index] > 0;
+        }
+        return mask;
+    }
+}
+
+template<int MaxPip>
+bool BasicDominoHistogram<MaxPip>::sameTiles(const BasicDominoHistogram& other) const {
+    return total == other.total && counts == other.counts;
+}
+
+template<int MaxPip>
+bool BasicDominoHistogram<MaxPip>::isSubsetOf(const BasicDominoHistogram& other) const {
+    bool subset = total <= other.total;
+    for (size_t index = 0; index < TILE_COUNT; index++) {
+        subset &= counts[index] <= other.counts[index];
+    }
+    return subset;
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip> BasicDominoHistogram<MaxPip>::setUnion(const BasicDominoHistogram& other) const {
+    BasicDominoHistogram result;
+    for (size_t index = 0; index < TILE_COUNT; index++) {
+        result.counts[index] = std::max(counts[index], other.counts[index]);
+        result.total += result.counts[index];
+    }
+    return result;
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip> BasicDominoHistogram<MaxPip>::setIntersection(const BasicDominoHistogram& other) const {
+    BasicDominoHistogram result;
+    for (size_t index = 0; index < TILE_COUNT; index++) {
+        result.counts[index] = std::min(counts[index], other.counts[index]);
+        result.total += result.counts[index];
+    }
+    return result;
+}
+
+template<int MaxPip>
+BasicDominoHistogram<MaxPip> BasicDominoHistogram<MaxPip>::setDifference(const BasicDominoHistogram& other) const {
+    BasicDominoHistogram result;
+    for (size_t index = 0; index < TILE_COUNT; index++) {
+        result.counts[index] = counts[index] - std::min(counts[index], other.counts[index]);
+        result.total += result.counts[index];
+    }
+    return result;
+}
+
+template<int MaxPip>
+size_t BasicDominoHistogram<MaxPip>::size() const {
+    return total;
+}
+
+template<int MaxPip>
+BasicDominoGroup<MaxPip> BasicDominoHistogram<MaxPip>::toGroup() const {
+    BasicDominoGroup<MaxPip> group;
+    group.reserve(total);
+    for (size_t index = 0; index < TILE_COUNT; index++) {
+        for (size_t k = 0; k < counts[index]; k++) {
+            group += Tables::fullSet[index];
+        }
+    }
+    return group;
+}
+
+template<int MaxPip>
+std::ostream& operator<<(std::ostream& out, const BasicDominoHistogram<MaxPip>& group) {
+    using Tables = BasicDominoTables<MaxPip>;
+    for (size_t index = 0; index < Tables::TILE_COUNT; index++) {
+        for (size_t k = 0; k < group.counts[index]; k++) {
+            out << Tables::fullSet[index] << " ";
+        }
+    }
+    return out;
+}
+
+template class BasicDominoHistogram<6>;
+template class BasicDominoHistogram<9>;
+template class BasicDominoHistogram<12>;
+template class BasicDominoHistogram<15>;
+
+template std::ostream& operator<<(std::ostream&, const BasicDominoHistogram<6>&);
+template std::ostream& operator<<(std::ostream&, const BasicDominoHistogram<9>&);
+template std::ostream& operator<<(std::ostream&, const BasicDominoHistogram<12>&);
+template std::ostream& operator<<(std::ostream&, const BasicDominoHistogram<15>&);
@@ -0,0 +1,184 @@
+#ifndef DOMINOHISTOGRAM_H
+#define DOMINOHISTOGRAM_H
+
+#include <array>
+#include "Domino.h"
+#include "DominoGroup.h"
+#include "DominoTables.h"
+
+/**
+ * @class BasicDominoHistogram
+ * @brief Группа домино, хранимая как мультимножество: по одному счетчику на каждую кость набора.
+ *
+ * В отличие от BasicDominoGroup порядок и ориентация костей не хранятся, зато добавление,
+ * удаление по значению, подсчет и выборка по значению стороны выполняются за O(1)
+ * (или за время, пропорциональное результату). Открытый интерфейс совпадает с DominoGroup
+ * (operator+=, getDomino, getSubGroup, size, operator<<), поэтому представление можно сменить,
+ * не меняя вызывающий код. Для набора 0..6 доступно имя DominoHistogram.
+ * @tparam MaxPip Наибольшее значение стороны (6, 9, 12 или 15).
+ */
+template<int MaxPip>
+class BasicDominoHistogram {
+public:
+    using Tile = BasicDomino<MaxPip>;         /**< Тип домино набора. */
+    using Tables = BasicDominoTables<MaxPip>; /**< Таблицы набора. */
+    static constexpr size_t TILE_COUNT = Tables::TILE_COUNT; /**< Количество различных костей в наборе 0..MaxPip. */
+
+private:
+    std::array<size_t, TILE_COUNT> counts; /**< Количество экземпляров каждой кости в каноническом порядке. */
+    size_t total;                          /**< Общее количество домино в группе. */
+
+public:
+    /**
+     * @brief Конструктор по умолчанию, создающий пустую группу.
+     */
+    BasicDominoHistogram() noexcept;
+
+    /**
+     * @brief Конструктор, принимающий список инициализации.
+     * @param initList Список домино для инициализации группы.
+     */
+    BasicDominoHistogram(std::initializer_list<Tile> initList);
+
+    /**
+     * @brief Строит гистограмму по обычной группе домино.
+     *
+     * Количества берутся из индекса группы за O(TILE_COUNT), домино группы не перебираются.
+     * @param group Исходная группа.
+     */
+    explicit BasicDominoHistogram(const BasicDominoGroup<MaxPip>& group);
+
+    /**
+     * @brief Генерирует полный набор домино за O(TILE_COUNT), без перебора отдельных костей.
+     * @param repeat Количество повторений каждой домино комбинации (по умолчанию 1).
+     * @return Полный набор домино.
+     */
+    static BasicDominoHistogram generateFullSet(int repeat = 1);
+
+    /**
+     * @brief Возвращает канонический номер кости (0..TILE_COUNT - 1), не зависящий от ориентации.
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Номер кости в порядке generateFullSet: (0|0), (0|1), ..., (MaxPip|MaxPip).
+     */
+    static size_t indexOf(int left, int right);
+
+    /**
+     * @brief Добавляет домино в группу за O(1).
+     * @param domino Домино, которое нужно добавить.
+     * @return Ссылка на текущий объект после добавления.
+     */
+    BasicDominoHistogram& operator+=(const Tile& domino);
+
+    /**
+     * @brief Удаляет и возвращает конкретное домино по значениям сторон за O(1).
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Удаленное домино в запрошенной ориентации.
+     * @throws std::invalid_argument Если указанного домино не существует.
+     */
+    Tile getDomino(int left, int right);
+
+    /**
+     * @brief Возвращает количество экземпляров указанного домино за O(1).
+     * @param left Левая сторона домино.
+     * @param right Правая сторона домино.
+     * @return Количество экземпляров (ориентация не учитывается).
+     */
+    size_t count(int left, int right) const;
+
+    /**
+     * @brief Извлекает подгруппу домино с одной из сторон, равной указанному значению.
+     *
+     * Перебирает только MaxPip + 1 костей, содержащих value, поэтому не зависит от размера группы.
+     * @param value Значение для фильтрации домино.
+     * @return Группа домино, у которых одна из сторон равна value.
+     */
+    BasicDominoHistogram getSubGroup(int value);
+
+    /**
+     * @brief Возвращает множество различных костей группы.
+     * @return Маска, в которой отмечены кости, присутствующие хотя бы в одном экземпляре.
+     */
+    typename Tables::TileMask tileMask() const;
+
+    /**
+     * @brief Проверяет, что группы состоят из одних и тех же костей с учетом повторений.
+     * @param other Другая группа.
+     * @return true, если счетчики всех костей совпадают.
+     */
+    bool sameTiles(const BasicDominoHistogram& other) const;
+
+    /**
+     * @brief Проверяет, что каждая кость группы входит в other не меньшее число раз.
+     * @param other Другая группа.
+     * @return true, если группа — подмножество other (с учетом повторений).
+     */
+    bool isSubsetOf(const BasicDominoHistogram& other) const;
+
+    /**
+     * @brief Объединение: каждая кость входит наибольшее из двух количеств раз.
+     * @param other Другая группа.
+     * @return Новая группа.
+     */
+    BasicDominoHistogram setUnion(const BasicDominoHistogram& other) const;
+
+    /**
+     * @brief Пересечение: каждая кость входит наименьшее из двух количеств раз.
+     * @param other Другая группа.
+     * @return Новая группа.
+     */
+    BasicDominoHistogram setIntersection(const BasicDominoHistogram& other) const;
+
+    /**
+     * @brief Разность: из количества каждой кости вычитается ее количество в other (не меньше нуля).
+     * @param other Вычитаемая группа.
+     * @return Новая группа.
+     */
+    BasicDominoHistogram setDifference(const BasicDominoHistogram& other) const;
+
+    /**
+     * @brief Сравнивает группы как мультимножества костей, см. sameTiles.
+     * @param other Другая группа.
+     * @return true, если группы совпадают.
+     */
+    bool operator==(const BasicDominoHistogram& other) const {
+        return sameTiles(other);
+    }
+
+    /**
+     * @brief Возвращает количество домино в группе.
+     * @return Количество домино.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Разворачивает гистограмму в обычную группу в каноническом порядке.
+     * @return Группа домино с теми же костями.
+     */
+    BasicDominoGroup<MaxPip> toGroup() const;
+
+    /**
+     * @brief Перегруженный оператор вывода группы домино в поток в каноническом порядке.
+     * @param out Выходной поток.
+     * @param group Группа домино.
+     * @return Выходной поток.
+     */
+    template<int P>
+    friend std::ostream& operator<<(std::ostream& out, const BasicDominoHistogram<P>& group);
+};
+
+template<int MaxPip>
+std::ostream& operator<<(std::ostream& out, const BasicDominoHistogram<MaxPip>& group);
+
+extern template class BasicDominoHistogram<6>;
+extern template class BasicDominoHistogram<9>;
+extern template class BasicDominoHistogram<12>;
+extern template class BasicDominoHistogram<15>;
+
+using DominoHistogram = BasicDominoHistogram<6>;    /**< Гистограмма классического набора 0..6. */
+using DominoHistogram9 = BasicDominoHistogram<9>;   /**< Гистограмма набора 0..9. */
+using DominoHistogram12 = BasicDominoHistogram<12>; /**< Гистограмма набора 0..12. */
+using DominoHistogram15 = BasicDominoHistogram<15>; /**< Гистограмма набора 0..15. */
+
+#endif
@@ -0,0 +1,144 @@
+#include "DominoInstrumentation.h"
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+    constexpr size_t COUNTERS = static_cast<size_t>(DominoCounter::Count);
+    constexpr size_t OPERATIONS = static_cast<size_t>(DominoOperation::Count);
+
+    constexpr const char* COUNTER_NAMES[COUNTERS] = {
+        "allocations", "bytesAllocated", "bytesCopied", "elementsShifted", "comparisons"
+    };
+
+    constexpr const char* OPERATION_NAMES[OPERATIONS] = {
+        "reserve", "append", "createRandomGroup", "generateFullSet", "getDomino", "getByIndex",
+        "getRandomDomino", "getSubGroup", "extractIf", "eraseIf", "sortDominoes", "rebuildIndex",
+        "deal", "save", "load"
+    };
+
+    /**
+     * @brief Счетчики одного потока.
+     *
+     * Пишет в них только поток-владелец (загрузка и запись без атомарного сложения), а
+     * snapshot читает их из другого потока, поэтому значения атомарные.
+     */
+    struct ThreadCounters {
+        std::array<std::atomic<std::uint64_t>, COUNTERS> counters{};
+        std::array<std::atomic<std::uint64_t>, OPERATIONS> calls{};
+        std::array<std::atomic<std::uint64_t>, OPERATIONS> nanoseconds{};
+
+        static void bump(std::atomic<std::uint64_t>& value, std::uint64_t amount) noexcept {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        void addTo(DominoInstrumentationSnapshot& total) const noexcept {
+            for (size_t i = 0; i < COUNTERS; i++) {
+                total.counters[i] += counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < OPERATIONS; i++) {
+                total.operations[i].calls += calls[i].load(std::memory_order_relaxed);
+                total.operations[i].nanoseconds += nanoseconds[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        void clear() noexcept {
+            for (auto& value : counters) value.store(0, std::memory_order_relaxed);
+            for (auto& value : calls) value.store(0, std::memory_order_relaxed);
+            for (auto& value : nanoseconds) value.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Список счетчиков живых потоков и сумма счетчиков завершившихся.
+     */
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters*> live;
+        DominoInstrumentationSnapshot retired;
+
+        static Registry& instance() {
+            static Registry registry;
+            return registry;
+        }
+    };
+
+    /**
+     * @brief Регистрирует счетчики потока при первом обращении и переносит их в retired при завершении.
+     */
+    struct ThreadSlot {
+        ThreadCounters counters;
+
+        ThreadSlot() {
+            Registry& registry = Registry::instance();
+            std::lock_guard lock(registry.mutex);
+            registry.live.push_back(&counters);
+        }
+
+        ~ThreadSlot() {
+            Registry& registry = Registry::instance();
+            std::lock_guard lock(registry.mutex);
+            counters.addTo(registry.retired);
+            std::erase(registry.live, &counters);
+        }
+    };
+
+    ThreadCounters& local() {
+        thread_local ThreadSlot slot;
+        return slot.counters;
+    }
+}
+
+void DominoInstrumentation::addCounter(size_t counter, std::uint64_t amount) noexcept {
+    ThreadCounters::bump(local().counters[counter], amount);
+}
+
+void DominoInstrumentation::recordOperation(size_t operation, std::uint64_t nanoseconds) noexcept {
+    ThreadCounters& counters = local();
+    ThreadCounters::bump(counters.calls[operation], 1);
+    ThreadCounters::bump(counters.nanoseconds[operation], nanoseconds);
+}
+
+DominoInstrumentationSnapshot DominoInstrumentation::snapshot() {
+    DominoInstrumentationSnapshot total;
+    if constexpr (enabled) {
+        Registry& registry = Registry::instance();
+        std::lock_guard lock(registry.mutex);
+        total = registry.retired;
+        for (const ThreadCounters* counters : registry.live) {
+            counters->addTo(total);
+        }
+    }
+    return total;
+}
+
+void DominoInstrumentation::reset() {
+    if constexpr (enabled) {
+        Registry& registry = Registry::instance();
+        std::lock_guard lock(registry.mutex);
+        registry.retired = {};
+        for (ThreadCounters* counters : registry.live) {
+            counters->clear();
+        }
+    }
+}
+
+void DominoInstrumentationSnapshot::writeJson(std::ostream& out) const {
+    out << "{\"enabled\":" << (DominoInstrumentation::enabled ? "true" : "false") << ",\"counters\":{";
+    for (size_t i = 0; i < COUNTERS; i++) {
+        out << (i ? "," : "") << '"' << COUNTER_NAMES[i] << "\":" << counters[i];
+    }
+    out << "},\"operations\":{";
+    for (size_t i = 0; i < OPERATIONS; i++) {
+        out << (i ? "," : "") << '"' << OPERATION_NAMES[i] << "\":{\"calls\":" << operations[i].calls
+            << ",\"nanoseconds\":" << operations[i].nanoseconds << '}';
+    }
+    out << "}}";
+}
+
+std::string DominoInstrumentationSnapshot::toJson() const {
+    std::ostringstream out;
+    writeJson(out);
+    return out.str();
+}
@@ -0,0 +1,195 @@
+#ifndef DOMINOINSTRUMENTATION_H
+#define DOMINOINSTRUMENTATION_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#ifndef DOMINO_INSTRUMENTATION
+#define DOMINO_INSTRUMENTATION 0
+#endif
+
+/**
+ * @enum DominoCounter
+ * @brief Счетчики работы с памятью и сравнений в DominoGroup.
+ */
+enum class DominoCounter {
+    Allocations,     /**< Выделения массива домино. */
+    BytesAllocated,  /**< Выделено байт под массивы домино. */
+    BytesCopied,     /**< Скопировано байт при росте массива, копировании и присваивании групп. */
+    ElementsShifted, /**< Домино, сдвинутых при удалении из середины (getDomino, getByIndex, extractIf, eraseIf). */
+    Comparisons,     /**< Домино, просмотренных при поиске по значению. */
+    Count            /**< Количество счетчиков. */
+};
+
+/**
+ * @enum DominoOperation
+ * @brief Операции DominoGroup, для которых считаются вызовы и время.
+ */
+enum class DominoOperation {
+    Reserve,           /**< reserve и рост массива при добавлении. */
+    Append,            /**< append. */
+    CreateRandomGroup, /**< createRandomGroup. */
+    GenerateFullSet,   /**< generateFullSet. */
+    GetDomino,         /**< getDomino. */
+    GetByIndex,        /**< getByIndex. */
+    GetRandomDomino,   /**< getRandomDomino. */
+    GetSubGroup,       /**< getSubGroup. */
+    ExtractIf,         /**< extractIf. */
+    EraseIf,           /**< eraseIf. */
+    SortDominoes,      /**< sortDominoes. */
+    RebuildIndex,      /**< Пересчет индекса костей после массового изменения. */
+    Deal,              /**< deal. */
+    Save,              /**< save. */
+    Load,              /**< load. */
+    Count              /**< Количество операций. */
+};
+
+/**
+ * @struct DominoOperationStats
+ * @brief Количество вызовов операции и суммарное время их выполнения.
+ */
+struct DominoOperationStats {
+    std::uint64_t calls = 0;       /**< Количество вызовов. */
+    std::uint64_t nanoseconds = 0; /**< Суммарное время выполнения в наносекундах. */
+};
+
+/**
+ * @struct DominoInstrumentationSnapshot
+ * @brief Сумма счетчиков всех потоков на момент вызова DominoInstrumentation::snapshot.
+ */
+struct DominoInstrumentationSnapshot {
+    std::array<std::uint64_t, static_cast<size_t>(DominoCounter::Count)> counters{}; /**< Значения DominoCounter. */
+    std::array<DominoOperationStats, static_cast<size_t>(DominoOperation::Count)> operations{}; /**< Статистика DominoOperation. */
+
+    /**
+     * @brief Возвращает значение счетчика.
+     * @param counter Счетчик.
+     * @return Значение.
+     */
+    std::uint64_t operator[](DominoCounter counter) const noexcept {
+        return counters[static_cast<size_t>(counter)];
+    }
+
+    /**
+     * @brief Возвращает статистику операции.
+     * @param operation Операция.
+     * @return Количество вызовов и время.
+     */
+    const DominoOperationStats& operator[](DominoOperation operation) const noexcept {
+        return operations[static_cast<size_t>(operation)];
+    }
+
+    /**
+     * @brief Записывает снимок в поток в формате JSON.
+     * @param out Выходной поток.
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * @brief Возвращает снимок в формате JSON.
+     * @return Текст JSON.
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @class DominoInstrumentation
+ * @brief Необязательные счетчики операций DominoGroup, включаемые при сборке.
+ *
+ * Включаются опцией CMake DOMINO_INSTRUMENTATION (макрос DOMINO_INSTRUMENTATION=1). Каждый
+ * поток пишет в собственные счетчики, поэтому потоки не конкурируют за линии кэша; snapshot
+ * складывает счетчики всех потоков, включая завершившиеся. Без опции add и DominoScopeTimer
+ * пусты и компилируются в ничто, а snapshot возвращает нули.
+ */
+class DominoInstrumentation {
+public:
+    static constexpr bool enabled = DOMINO_INSTRUMENTATION != 0; /**< Счетчики включены при сборке. */
+
+    /**
+     * @brief Увеличивает счетчик текущего потока.
+     * @param counter Счетчик.
+     * @param amount Величина увеличения.
+     */
+    static void add(DominoCounter counter, std::uint64_t amount = 1) noexcept {
+        if constexpr (enabled) {
+            addCounter(static_cast<size_t>(counter), amount);
+        } else {
+            (void) counter;
+            (void) amount;
+        }
+    }
+
+    /**
+     * @brief Учитывает один вызов операции текущего потока.
+     * @param operation Операция.
+     * @param nanoseconds Время выполнения вызова.
+     */
+    static void record(DominoOperation operation, std::uint64_t nanoseconds) noexcept {
+        if constexpr (enabled) {
+            recordOperation(static_cast<size_t>(operation), nanoseconds);
+        } else {
+            (void) operation;
+            (void) nanoseconds;
+        }
+    }
+
+    /**
+     * @brief Складывает счетчики всех потоков.
+     * @return Снимок счетчиков (нулевой, если счетчики выключены).
+     */
+    static DominoInstrumentationSnapshot snapshot();
+
+    /**
+     * @brief Обнуляет счетчики всех потоков.
+     *
+     * Увеличения, выполняемые другими потоками одновременно со сбросом, могут быть потеряны.
+     */
+    static void reset();
+
+private:
+    static void addCounter(size_t counter, std::uint64_t amount) noexcept;
+    static void recordOperation(size_t operation, std::uint64_t nanoseconds) noexcept;
+};
+
+/**
+ * @class DominoScopeTimer
+ * @brief Замеряет время от создания до уничтожения и учитывает его как вызов операции.
+ *
+ * Без DOMINO_INSTRUMENTATION объект пуст, а конструктор и деструктор тривиальны.
+ */
+class DominoScopeTimer {
+public:
+#if DOMINO_INSTRUMENTATION
+    /**
+     * @brief Начинает замер операции.
+     * @param operation Операция.
+     */
+    explicit DominoScopeTimer(DominoOperation operation) noexcept
+            : operation(operation), start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Завершает замер и учитывает вызов.
+     */
+    ~DominoScopeTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        DominoInstrumentation::record(operation, static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+#else
+    explicit DominoScopeTimer(DominoOperation) noexcept {}
+#endif
+
+    DominoScopeTimer(const DominoScopeTimer&) = delete;
+    DominoScopeTimer& operator=(const DominoScopeTimer&) = delete;
+
+#if DOMINO_INSTRUMENTATION
+private:
+    DominoOperation operation;                    /**< Замеряемая операция. */
+    std::chrono::steady_clock::time_point start;  /**< Момент начала замера. */
+#endif
+};
+
+#endif
@@ -0,0 +1,10 @@
+#include "DominoRandom.h"
+#include <random>
+
+DominoRng& DominoRng::threadLocal() {
+    thread_local DominoRng gen([] {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    }());
+    return gen;
+}
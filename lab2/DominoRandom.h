@@ -0,0 +1,135 @@
+#ifndef DOMINORANDOM_H
+#define DOMINORANDOM_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/**
+ * @class DominoRng
+ * @brief Быстрый генератор псевдослучайных чисел xoshiro256** для генерации домино.
+ *
+ * Состояние занимает 32 байта, один вызов дает 64 случайных бита. Генератор удовлетворяет
+ * требованиям UniformRandomBitGenerator, поэтому его можно передавать в стандартные
+ * распределения, а в шаблонные методы домино можно передавать любой стандартный генератор.
+ * Пара (seed, stream) задает независимый воспроизводимый поток.
+ */
+class DominoRng {
+private:
+    std::uint64_t state[4]; /**< Состояние генератора. */
+
+    /**
+     * @brief Шаг генератора SplitMix64, используется для инициализации состояния.
+     * @param x Изменяемое состояние SplitMix64.
+     * @return Следующее псевдослучайное значение.
+     */
+    static std::uint64_t splitMix(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Создает генератор для заданного зерна и номера потока.
+     * @param seed Зерно генератора.
+     * @param stream Номер потока; разные потоки с одним зерном не пересекаются на практике.
+     */
+    explicit DominoRng(std::uint64_t seed = 0, std::uint64_t stream = 0) {
+        std::uint64_t x = seed ^ splitMix(stream);
+        for (auto& word : state) {
+            word = splitMix(x);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Возвращает следующие 64 случайных бита.
+     */
+    result_type operator()() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Отображает 64 случайных бита в диапазон [0, bound) одним умножением.
+     *
+     * Смещение не превышает bound / 2^64, что пренебрежимо мало для небольших bound.
+     * @param bits Случайные биты.
+     * @param bound Верхняя граница (не включается).
+     * @return Число из диапазона [0, bound).
+     */
+    static std::uint64_t scale(std::uint64_t bits, std::uint64_t bound) {
+#ifdef __SIZEOF_INT128__
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>(bits) * bound) >> 64);
+#else
+        return bits % bound;
+#endif
+    }
+
+    /**
+     * @brief Возвращает равномерно распределенное число из [0, bound) без смещения.
+     *
+     * Для генераторов с полным 64-битным выходом (например, DominoRng) используется метод Лемира:
+     * умножение на bound и отбраковка редких неудачных значений, деление выполняется только при
+     * отбраковке. Остальные генераторы (например, std::mt19937) передаются в
+     * std::uniform_int_distribution, которая сама собирает нужное число бит.
+     * @tparam Generator Тип, удовлетворяющий UniformRandomBitGenerator.
+     * @param gen Генератор случайных чисел.
+     * @param bound Верхняя граница (не включается), больше нуля.
+     * @return Число из диапазона [0, bound).
+     */
+    template<typename Generator>
+    static std::uint64_t bounded(Generator& gen, std::uint64_t bound) {
+        if constexpr (Generator::min() != 0 || Generator::max() != std::numeric_limits<std::uint64_t>::max()) {
+            return std::uniform_int_distribution<std::uint64_t>(0, bound - 1)(gen);
+        } else {
+#ifdef __SIZEOF_INT128__
+            unsigned __int128 product = static_cast<unsigned __int128>(gen()) * bound;
+            auto low = static_cast<std::uint64_t>(product);
+            if (low < bound) {
+                const std::uint64_t threshold = (0 - bound) % bound;
+                while (low < threshold) {
+                    product = static_cast<unsigned __int128>(gen()) * bound;
+                    low = static_cast<std::uint64_t>(product);
+                }
+            }
+            return static_cast<std::uint64_t>(product >> 64);
+#else
+            const std::uint64_t limit = max() - max() % bound;
+            std::uint64_t bits;
+            do {
+                bits = gen();
+            } while (bits >= limit);
+            return bits % bound;
+#endif
+        }
+    }
+
+    /**
+     * @brief Возвращает генератор текущего потока выполнения.
+     *
+     * Каждый поток получает собственный генератор, инициализированный из std::random_device,
+     * поэтому обращение к нему не требует синхронизации.
+     * @return Ссылка на генератор текущего потока.
+     */
+    static DominoRng& threadLocal();
+};
+
+#endif
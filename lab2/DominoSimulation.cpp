@@ -0,0 +1,270 @@
+#include "DominoSimulation.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    constexpr size_t GAMES_PER_BATCH = 256; /**< Количество партий в одном пакете работы. */
+
+    /**
+     * @brief Диапазон пакетов одного потока: владелец берет с начала, остальные — с конца.
+     */
+    struct WorkRange {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    bool takeBatch(std::vector<WorkRange>& ranges, size_t self, size_t& batch) {
+        {
+            std::lock_guard<std::mutex> guard(ranges[self].lock);
+            if (ranges[self].begin < ranges[self].end) {
+                batch = ranges[self].begin++;
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < ranges.size(); offset++) {
+            WorkRange& victim = ranges[(self + offset) % ranges.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.begin < victim.end) {
+                batch = --victim.end;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int pipSum(const DominoGroup& hand) {
+        int sum = 0;
+        for (size_t i = 0; i < hand.size(); i++) {
+            sum += hand[static_cast<int>(i)].getLeft() + hand[static_cast<int>(i)].getRight();
+        }
+        return sum;
+    }
+
+    void collectMoves(const DominoGroup& hand, int leftEnd, int rightEnd, std::vector<DominoMove>& moves) {
+        moves.clear();
+        // Индекс руки отвечает без просмотра, поэтому добор до первого хода не сканирует руку каждый раз
+        if (leftEnd != -1 && hand.countPlayable(leftEnd, rightEnd) == 0) return;
+        for (size_t i = 0; i < hand.size(); i++) {
+            const Domino& d = hand[static_cast<int>(i)];
+            if (leftEnd == -1) {
+                moves.push_back({i, false});
+                continue;
+            }
+            if (d.getLeft() == leftEnd || d.getRight() == leftEnd) {
+                moves.push_back({i, true});
+            }
+            if (rightEnd != leftEnd && (d.getLeft() == rightEnd || d.getRight() == rightEnd)) {
+                moves.push_back({i, false});
+            }
+        }
+    }
+
+    void validate(const DominoSimulationConfig& config) {
+        if (config.players < 2 || config.players > 4) {
+            throw std::invalid_argument("Players should be between 2 and 4");
+        }
+        if (config.handSize == 0 || config.players * config.handSize > 28) {
+            throw std::invalid_argument("Not enough dominoes to deal");
+        }
+        if (!config.policies.empty() && config.policies.size() != config.players) {
+            throw std::invalid_argument("Policies should be given for every player");
+        }
+    }
+}
+
+double DominoSimulationStats::winRate(size_t player) const {
+    return games == 0 ? 0.0 : static_cast<double>(wins.at(player)) / static_cast<double>(games);
+}
+
+double DominoSimulationStats::averagePipsLeft(size_t player) const {
+    return games == 0 ? 0.0 : static_cast<double>(pipsLeft.at(player)) / static_cast<double>(games);
+}
+
+double DominoSimulationStats::averageLength() const {
+    return games == 0 ? 0.0 : static_cast<double>(tilesPlayed) / static_cast<double>(games);
+}
+
+DominoSimulationStats& DominoSimulationStats::operator+=(const DominoSimulationStats& other) {
+    wins.resize(std::max(wins.size(), other.wins.size()), 0);
+    pipsLeft.resize(std::max(pipsLeft.size(), other.pipsLeft.size()), 0);
+    for (size_t i = 0; i < other.wins.size(); i++) wins[i] += other.wins[i];
+    for (size_t i = 0; i < other.pipsLeft.size(); i++) pipsLeft[i] += other.pipsLeft[i];
+    games += other.games;
+    blocked += other.blocked;
+    ties += other.ties;
+    tilesPlayed += other.tilesPlayed;
+    return *this;
+}
+
+DominoSimulationStats DominoSimulation::playGame(const DominoSimulationConfig& config, DominoRng& gen, size_t firstPlayer) {
+    validate(config);
+    const size_t players = config.players;
+    DominoDeal dealt = DominoGroup::deal(players, config.handSize, gen);
+
+    DominoSimulationStats stats;
+    stats.games = 1;
+    stats.wins.assign(players, 0);
+    stats.pipsLeft.assign(players, 0);
+
+    std::vector<DominoMove> moves;
+    int leftEnd = -1;
+    int rightEnd = -1;
+    size_t player = firstPlayer % players;
+    size_t passes = 0;
+    size_t winner = players;
+
+    while (true) {
+        DominoGroup& hand = dealt.hands[player];
+        collectMoves(hand, leftEnd, rightEnd, moves);
+        if (config.rules == DominoRules::Draw) {
+            while (moves.empty() && dealt.boneyard.size() > 0) {
+                hand += dealt.boneyard.getRandomDomino(gen);
+                collectMoves(hand, leftEnd, rightEnd, moves);
+            }
+        }
+
+        if (moves.empty()) {
+            if (++passes == players) {
+                stats.blocked = 1;
+                break;
+            }
+            player = (player + 1) % players;
+            continue;
+        }
+        passes = 0;
+
+        DominoTableView view{hand, moves, leftEnd, rightEnd, dealt.boneyard.size(), player};
+        size_t choice = config.policies.empty() ? firstPlayable(view, gen) : config.policies[player](view, gen);
+        if (choice >= moves.size()) {
+            throw std::out_of_range("Policy returned an invalid move");
+        }
+
+        DominoMove move = moves[choice];
+        Domino tile = hand.getByIndex(static_cast<int>(move.index));
+        if (leftEnd == -1) {
+            leftEnd = tile.getLeft();
+            rightEnd = tile.getRight();
+        } else if (move.atLeft) {
+            leftEnd = tile.getLeft() == leftEnd ? tile.getRight() : tile.getLeft();
+        } else {
+            rightEnd = tile.getLeft() == rightEnd ? tile.getRight() : tile.getLeft();
+        }
+        ++stats.tilesPlayed;
+
+        if (hand.size() == 0) {
+            winner = player;
+            break;
+        }
+        player = (player + 1) % players;
+    }
+
+    int lowest = 0;
+    size_t holders = 0;
+    for (size_t p = 0; p < players; p++) {
+        int pips = pipSum(dealt.hands[p]);
+        stats.pipsLeft[p] = static_cast<std::uint64_t>(pips);
+        if (p == 0 || pips < lowest) {
+            lowest = pips;
+            holders = 0;
+            if (stats.blocked) winner = p;
+        }
+        if (pips == lowest) ++holders;
+    }
+
+    // В «рыбе» побеждает игрок с наименьшей суммой очков, при равенстве — ничья
+    if (stats.blocked && holders > 1) {
+        stats.ties = 1;
+    } else {
+        stats.wins[winner] = 1;
+    }
+    return stats;
+}
+
+DominoSimulationStats DominoSimulation::run(const DominoSimulationConfig& config, size_t games) {
+    validate(config);
+
+    size_t batches = (games + GAMES_PER_BATCH - 1) / GAMES_PER_BATCH;
+    size_t workers = config.threads == 0 ? std::thread::hardware_concurrency() : config.threads;
+    workers = std::clamp<size_t>(std::min(workers, batches), 1, 256);
+
+    std::vector<WorkRange> ranges(workers);
+    for (size_t w = 0; w < workers; w++) {
+        ranges[w].begin = batches * w / workers;
+        ranges[w].end = batches * (w + 1) / workers;
+    }
+
+    std::vector<DominoSimulationStats> partial(workers);
+    // Исключение из партии (например, из политики) не должно покидать поток: оно сохраняется,
+    // остальные потоки прекращают брать пакеты, а после join исключение бросается заново
+    std::vector<std::exception_ptr> errors(workers);
+    std::atomic<bool> failed{false};
+    auto work = [&](size_t self) {
+        try {
+            DominoSimulationStats& stats = partial[self];
+            stats.wins.assign(config.players, 0);
+            stats.pipsLeft.assign(config.players, 0);
+            size_t batch;
+            while (!failed.load(std::memory_order_relaxed) && takeBatch(ranges, self, batch)) {
+                size_t end = std::min(games, (batch + 1) * GAMES_PER_BATCH);
+                for (size_t game = batch * GAMES_PER_BATCH; game < end; game++) {
+                    DominoRng gen(config.seed, game);
+                    stats += playGame(config, gen, game % config.players);
+                }
+            }
+        } catch (...) {
+            errors[self] = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    try {
+        for (size_t w = 1; w < workers; w++) {
+            pool.emplace_back(work, w);
+        }
+    } catch (...) {
+        failed.store(true, std::memory_order_relaxed);
+        for (auto& thread : pool) thread.join();
+        throw;
+    }
+    work(0);
+    for (auto& thread : pool) thread.join();
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    DominoSimulationStats total;
+    total.wins.assign(config.players, 0);
+    total.pipsLeft.assign(config.players, 0);
+    for (const auto& stats : partial) {
+        total += stats;
+    }
+    return total;
+}
+
+size_t DominoSimulation::firstPlayable(const DominoTableView&, DominoRng&) {
+    return 0;
+}
+
+size_t DominoSimulation::heaviestTile(const DominoTableView& view, DominoRng&) {
+    size_t best = 0;
+    int bestPips = -1;
+    for (size_t i = 0; i < view.moves.size(); i++) {
+        const Domino& d = view.hand[static_cast<int>(view.moves[i].index)];
+        int pips = d.getLeft() + d.getRight();
+        if (pips > bestPips) {
+            bestPips = pips;
+            best = i;
+        }
+    }
+    return best;
+}
+
+size_t DominoSimulation::randomMove(const DominoTableView& view, DominoRng& gen) {
+    return DominoRng::bounded(gen, view.moves.size());
+}
@@ -0,0 +1,143 @@
+#ifndef DOMINOSIMULATION_H
+#define DOMINOSIMULATION_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Domino.h"
+#include "DominoGroup.h"
+
+/**
+ * @enum DominoRules
+ * @brief Правила партии.
+ */
+enum class DominoRules {
+    Block, /**< Без добора: игрок без хода пропускает ход. */
+    Draw   /**< С добором: игрок без хода берет домино из базара, пока не сможет сходить или базар не кончится. */
+};
+
+/**
+ * @struct DominoMove
+ * @brief Допустимый ход: какое домино из руки и к какому концу линии его приставить.
+ */
+struct DominoMove {
+    size_t index; /**< Индекс домино в руке. */
+    bool atLeft;  /**< true — к левому концу линии, false — к правому (или первый ход). */
+};
+
+/**
+ * @struct DominoTableView
+ * @brief То, что видит игрок в момент хода.
+ */
+struct DominoTableView {
+    const DominoGroup& hand;            /**< Рука игрока. */
+    const std::vector<DominoMove>& moves; /**< Допустимые ходы (не пустой список). */
+    int leftEnd;                        /**< Значение на левом конце линии или -1, если линия пуста. */
+    int rightEnd;                       /**< Значение на правом конце линии или -1, если линия пуста. */
+    size_t boneyardSize;                /**< Количество домино в базаре. */
+    size_t player;                      /**< Номер игрока. */
+};
+
+/**
+ * @brief Стратегия игрока: по ситуации на столе возвращает индекс хода в view.moves.
+ *
+ * Стратегия вызывается одновременно из нескольких потоков, поэтому не должна иметь
+ * общего изменяемого состояния. Для случайных решений следует использовать переданный генератор:
+ * только тогда результат моделирования воспроизводим.
+ */
+using DominoPolicy = std::function<size_t(const DominoTableView& view, DominoRng& gen)>;
+
+/**
+ * @struct DominoSimulationConfig
+ * @brief Параметры моделирования.
+ */
+struct DominoSimulationConfig {
+    size_t players = 2;                    /**< Количество игроков (от 2 до 4). */
+    size_t handSize = 7;                   /**< Количество домино в начальной руке. */
+    DominoRules rules = DominoRules::Block; /**< Правила партии. */
+    std::vector<DominoPolicy> policies;    /**< Стратегии игроков; если пусто — DominoSimulation::firstPlayable. */
+    std::uint64_t seed = 0;                /**< Зерно: партия i играется с генератором DominoRng(seed, i). */
+    unsigned threads = 0;                  /**< Количество потоков (0 — по числу ядер). */
+};
+
+/**
+ * @struct DominoSimulationStats
+ * @brief Сводная статистика по сыгранным партиям.
+ */
+struct DominoSimulationStats {
+    size_t games = 0;                   /**< Количество партий. */
+    std::vector<size_t> wins;           /**< Количество побед каждого игрока. */
+    size_t blocked = 0;                 /**< Количество партий, закончившихся «рыбой». */
+    size_t ties = 0;                    /**< Количество партий без победителя. */
+    std::vector<std::uint64_t> pipsLeft; /**< Сумма очков, оставшихся в руке каждого игрока. */
+    std::uint64_t tilesPlayed = 0;      /**< Сумма длин партий в выложенных домино. */
+
+    /**
+     * @brief Доля побед игрока.
+     */
+    double winRate(size_t player) const;
+    /**
+     * @brief Среднее количество очков, оставшихся в руке игрока в конце партии.
+     */
+    double averagePipsLeft(size_t player) const;
+    /**
+     * @brief Средняя длина партии в выложенных домино.
+     */
+    double averageLength() const;
+
+    /**
+     * @brief Добавляет статистику других партий.
+     * @param other Статистика для объединения.
+     * @return Ссылка на текущий объект.
+     */
+    DominoSimulationStats& operator+=(const DominoSimulationStats& other);
+};
+
+/**
+ * @class DominoSimulation
+ * @brief Многопоточное моделирование партий методом Монте-Карло.
+ *
+ * Каждая партия раздается из полного набора и играется по заданным правилам. Партии
+ * распределяются между потоками пакетами с перехватом работы (work stealing): у каждого
+ * потока свой диапазон пакетов, а освободившийся поток забирает пакеты с конца чужого диапазона.
+ * Партия i всегда использует генератор DominoRng(seed, i), а статистика складывается из
+ * целых чисел, поэтому результат не зависит от числа потоков.
+ */
+class DominoSimulation {
+public:
+    /**
+     * @brief Моделирует заданное количество партий.
+     * @param config Параметры моделирования.
+     * @param games Количество партий.
+     * @return Сводная статистика.
+     * @throws std::invalid_argument Если параметры партии недопустимы.
+     * @throws std::out_of_range Если политика вернула недопустимый ход. Исключение из любого потока
+     *         (в том числе из пользовательской политики) передается вызывающему после завершения
+     *         всех потоков; при нескольких исключениях бросается исключение потока с меньшим номером.
+     */
+    static DominoSimulationStats run(const DominoSimulationConfig& config, size_t games);
+
+    /**
+     * @brief Играет одну партию.
+     * @param config Параметры моделирования (seed и threads не используются).
+     * @param gen Генератор случайных чисел партии.
+     * @param firstPlayer Номер игрока, который ходит первым.
+     * @return Статистика одной партии.
+     */
+    static DominoSimulationStats playGame(const DominoSimulationConfig& config, DominoRng& gen, size_t firstPlayer = 0);
+
+    /**
+     * @brief Стратегия: первый допустимый ход.
+     */
+    static size_t firstPlayable(const DominoTableView& view, DominoRng& gen);
+    /**
+     * @brief Стратегия: избавиться от самого тяжелого домино.
+     */
+    static size_t heaviestTile(const DominoTableView& view, DominoRng& gen);
+    /**
+     * @brief Стратегия: случайный допустимый ход.
+     */
+    static size_t randomMove(const DominoTableView& view, DominoRng& gen);
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef DOMINOTABLES_H
+#define DOMINOTABLES_H
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <type_traits>
+#include "Domino.h"
+
+/**
+ * @struct BasicDominoTables
+ * @brief Таблицы, вычисляемые на этапе компиляции, для алгоритмов над группами домино.
+ *
+ * Таблицы индексируются упорядоченным кодом домино BasicDomino::code() (left * PIPS + right),
+ * поэтому алгоритмы получают каноническое значение, сумму сторон или маску значений одним
+ * обращением к памяти вместо вычислений для каждого элемента.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+struct BasicDominoTables {
+    using Tile = BasicDomino<MaxPip>; /**< Тип домино набора. */
+    /**
+     * @brief Тип маски значений: бит v соответствует значению v.
+     */
+    using PipMask = std::conditional_t<(MaxPip < 8), std::uint8_t, std::uint16_t>;
+
+    static constexpr int PIPS = MaxPip + 1;                               /**< Количество различных значений стороны. */
+    static constexpr size_t TILE_COUNT = size_t(PIPS) * (PIPS + 1) / 2;   /**< Количество различных домино в полном наборе. */
+    static constexpr size_t ORDERED_COUNT = size_t(PIPS) * PIPS;          /**< Количество упорядоченных пар (left, right). */
+
+    /**
+     * @brief Множество костей без повторений: бит i соответствует кости с каноническим номером i.
+     *
+     * Для набора 0..6 это 28 бит в одном машинном слове, поэтому объединение, пересечение
+     * и проверка вложения выполняются одной командой.
+     */
+    using TileMask = std::bitset<TILE_COUNT>;
+
+    /**
+     * @brief Канонический номер домино (0..TILE_COUNT - 1) по значениям сторон, см. dominoCanonicalIndex.
+     */
+    static constexpr size_t canonical(int left, int right) noexcept {
+        return dominoCanonicalIndex(left, right, PIPS);
+    }
+
+    /**
+     * @brief Полный набор домино в каноническом порядке: (0|0), (0|1), ..., (MaxPip|MaxPip).
+     */
+    static constexpr std::array<Tile, TILE_COUNT> fullSet = [] {
+        std::array<Tile, TILE_COUNT> set{};
+        size_t index = 0;
+        for (int i = 0; i < PIPS; i++) {
+            for (int j = i; j < PIPS; j++) {
+                set[index++] = Tile(Tile::unchecked, static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(j));
+            }
+        }
+        return set;
+    }();
+
+    /**
+     * @brief Канонический номер для каждого упорядоченного кода.
+     */
+    static constexpr std::array<std::uint8_t, ORDERED_COUNT> canonicalIndex = [] {
+        std::array<std::uint8_t, ORDERED_COUNT> table{};
+        for (unsigned code = 0; code < ORDERED_COUNT; code++) {
+            table[code] = static_cast<std::uint8_t>(dominoCanonicalIndex(code / PIPS, code % PIPS, PIPS));
+        }
+        return table;
+    }();
+
+    /**
+     * @brief Сумма сторон для каждого упорядоченного кода.
+     */
+    static constexpr std::array<std::uint8_t, ORDERED_COUNT> pipSum = [] {
+        std::array<std::uint8_t, ORDERED_COUNT> table{};
+        for (unsigned code = 0; code < ORDERED_COUNT; code++) {
+            table[code] = static_cast<std::uint8_t>(code / PIPS + code % PIPS);
+        }
+        return table;
+    }();
+
+    /**
+     * @brief Маска значений, встречающихся на домино: бит v установлен, если одна из сторон равна v.
+     */
+    static constexpr std::array<PipMask, ORDERED_COUNT> pipMask = [] {
+        std::array<PipMask, ORDERED_COUNT> table{};
+        for (unsigned code = 0; code < ORDERED_COUNT; code++) {
+            table[code] = static_cast<PipMask>((1u << (code / PIPS)) | (1u << (code % PIPS)));
+        }
+        return table;
+    }();
+
+    /**
+     * @brief Случайные 64-битные ключи Зобриста для каждой кости в каноническом порядке.
+     *
+     * Хеш группы — сумма ключей всех ее домино по модулю 2^64: он не зависит от порядка и
+     * ориентации, учитывает повторения и обновляется при добавлении и удалении за O(1).
+     * Ключи получены генератором splitmix64 с фиксированным начальным значением, поэтому
+     * хеши одинаковы во всех запусках.
+     */
+    static constexpr std::array<std::uint64_t, TILE_COUNT> zobrist = [] {
+        std::array<std::uint64_t, TILE_COUNT> keys{};
+        std::uint64_t state = 0x646F6D696E6F5A42ull + MaxPip;
+        for (auto& key : keys) {
+            state += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }();
+
+    /**
+     * @brief Наибольшая длина текста домино "(l|r) " в байтах.
+     */
+    static constexpr size_t TEXT_WIDTH = MaxPip < 10 ? 6 : 8;
+
+    /**
+     * @brief Текст "(l|r) " для каждого упорядоченного кода, как его выводит operator<< группы.
+     *
+     * Для значений до 9 длина всех записей одинакова (6 байт), иначе она указана в textLength.
+     */
+    static constexpr std::array<std::array<char, TEXT_WIDTH>, ORDERED_COUNT> text = [] {
+        std::array<std::array<char, TEXT_WIDTH>, ORDERED_COUNT> table{};
+        for (unsigned code = 0; code < ORDERED_COUNT; code++) {
+            size_t length = 0;
+            auto put = [&](unsigned value) {
+                if (value >= 10) table[code][length++] = static_cast<char>('0' + value / 10);
+                table[code][length++] = static_cast<char>('0' + value % 10);
+            };
+            table[code][length++] = '(';
+            put(code / PIPS);
+            table[code][length++] = '|';
+            put(code % PIPS);
+            table[code][length++] = ')';
+            table[code][length++] = ' ';
+        }
+        return table;
+    }();
+
+    /**
+     * @brief Длина записи в таблице text для каждого упорядоченного кода.
+     */
+    static constexpr std::array<std::uint8_t, ORDERED_COUNT> textLength = [] {
+        std::array<std::uint8_t, ORDERED_COUNT> table{};
+        for (unsigned code = 0; code < ORDERED_COUNT; code++) {
+            table[code] = static_cast<std::uint8_t>(6 + (code / PIPS >= 10) + (code % PIPS >= 10));
+        }
+        return table;
+    }();
+
+    /**
+     * @brief Для каждого значения v — канонические номера всех PIPS домино, содержащих v, по возрастанию.
+     */
+    static constexpr std::array<std::array<std::uint8_t, PIPS>, PIPS> tilesWithPip = [] {
+        std::array<std::array<std::uint8_t, PIPS>, PIPS> table{};
+        for (int v = 0; v < PIPS; v++) {
+            for (int other = 0; other < PIPS; other++) {
+                table[v][other] = static_cast<std::uint8_t>(dominoCanonicalIndex(v, other, PIPS));
+            }
+        }
+        return table;
+    }();
+};
+
+using DominoTables = BasicDominoTables<6>; /**< Таблицы классического набора 0..6. */
+
+#endif
@@ -0,0 +1,200 @@
+#include "DominoTextParser.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    enum class Step { Done, NeedMore, Failed };
+
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline bool isDigit(char c) {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    /**
+     * @brief Разбор одного куска текста с учетом строк и смещений от начала всего текста.
+     */
+    template<int MaxPip>
+    struct Scanner {
+        using Tile = BasicDomino<MaxPip>;
+
+        const char* begin = nullptr;   /**< Начало куска. */
+        const char* end = nullptr;     /**< Конец куска. */
+        bool final = false;            /**< Кусок последний: конец куска — конец текста. */
+        size_t base = 0;               /**< Смещение начала куска от начала текста. */
+        size_t line = 1;               /**< Текущая строка. */
+        size_t lineStart = 0;          /**< Смещение начала текущей строки. */
+        DominoParseResult& result;
+
+        explicit Scanner(DominoParseResult& result) : result(result) {}
+
+        const char* skipSpace(const char* p) {
+            while (p != end && isSpace(*p)) {
+                if (*p == '\n') {
+                    ++line;
+                    lineStart = base + static_cast<size_t>(p - begin) + 1;
+                }
+                ++p;
+            }
+            return p;
+        }
+
+        Step fail(DominoParseError error, const char* at) {
+            result.error = error;
+            result.offset = base + static_cast<size_t>(at - begin);
+            result.line = line;
+            result.column = result.offset - lineStart + 1;
+            return Step::Failed;
+        }
+
+        Step atEnd(const char* p) {
+            return final ? fail(DominoParseError::UnexpectedEnd, p) : Step::NeedMore;
+        }
+
+        Step readValue(const char*& p, unsigned& value) {
+            if (p == end) return atEnd(p);
+            if (!isDigit(*p)) return fail(DominoParseError::UnexpectedCharacter, p);
+            const char* start = p;
+            value = 0;
+            do {
+                value = value * 10 + static_cast<unsigned>(*p - '0');
+                if (value > MaxPip) return fail(DominoParseError::ValueOutOfRange, start);
+                ++p;
+            } while (p != end && isDigit(*p));
+            // Число на границе куска может продолжаться в следующем
+            if (p == end && !final) return Step::NeedMore;
+            return Step::Done;
+        }
+
+        Step expect(const char*& p, char c) {
+            if (p == end) return atEnd(p);
+            if (*p != c) return fail(DominoParseError::UnexpectedCharacter, p);
+            ++p;
+            return Step::Done;
+        }
+
+        Step readTile(const char*& p, Tile& tile) {
+            unsigned left, right;
+            Step step;
+            if (*p == '(') {
+                ++p;
+                if ((step = readValue(p, left)) != Step::Done) return step;
+                if ((step = expect(p, '|')) != Step::Done) return step;
+                if ((step = readValue(p, right)) != Step::Done) return step;
+                if ((step = expect(p, ')')) != Step::Done) return step;
+            } else {
+                if ((step = readValue(p, left)) != Step::Done) return step;
+                if (p == end) return atEnd(p);
+                if (!isSpace(*p)) return fail(DominoParseError::UnexpectedCharacter, p);
+                p = skipSpace(p);
+                if ((step = readValue(p, right)) != Step::Done) return step;
+            }
+            tile = Tile(Tile::unchecked, static_cast<std::uint8_t>(left), static_cast<std::uint8_t>(right));
+            return Step::Done;
+        }
+
+        /**
+         * @brief Разбирает кусок до конца или до незаконченного домино.
+         * @return Место, с которого продолжить в следующем куске, или nullptr при ошибке.
+         */
+        const char* scan(std::vector<Tile>& out) {
+            const char* p = begin;
+            while (true) {
+                p = skipSpace(p);
+                if (p == end) return p;
+
+                const char* start = p;
+                size_t savedLine = line;
+                size_t savedLineStart = lineStart;
+                Tile tile;
+                Step step = readTile(p, tile);
+                if (step == Step::Done) {
+                    out.push_back(tile);
+                    ++result.tiles;
+                } else if (step == Step::NeedMore) {
+                    line = savedLine;
+                    lineStart = savedLineStart;
+                    return start;
+                } else {
+                    return nullptr;
+                }
+            }
+        }
+    };
+}
+
+template<int MaxPip>
+DominoParseResult BasicDominoTextParser<MaxPip>::parse(std::string_view text, BasicDominoGroup<MaxPip>& group) {
+    DominoParseResult result;
+    Scanner<MaxPip> scanner(result);
+    scanner.begin = text.data();
+    scanner.end = text.data() + text.size();
+    scanner.final = true;
+
+    std::vector<BasicDomino<MaxPip>> staged;
+    staged.reserve(text.size() / 4);
+    if (scanner.scan(staged) != nullptr) {
+        group.append(staged);
+    }
+    return result;
+}
+
+template<int MaxPip>
+DominoParseResult BasicDominoTextParser<MaxPip>::parse(std::istream& in, BasicDominoGroup<MaxPip>& group, size_t chunkSize) {
+    DominoParseResult result;
+    std::streambuf* source = in.rdbuf();
+    if (source == nullptr || !in.good()) {
+        result.error = DominoParseError::ReadFailed;
+        return result;
+    }
+
+    Scanner<MaxPip> scanner(result);
+    std::vector<BasicDomino<MaxPip>> staged;
+    std::string buffer(std::max<size_t>(chunkSize, 16), '\0');
+    size_t filled = 0;
+    bool final = false;
+    while (!final) {
+        // Незаконченное домино заняло весь буфер (например, длинная последовательность нулей)
+        if (filled == buffer.size()) buffer.resize(buffer.size() * 2);
+
+        // Каналы и сокеты могут вернуть меньше запрошенного: конец текста — только чтение нуля байт
+        size_t wanted = buffer.size() - filled;
+        size_t got = 0;
+        while (got < wanted) {
+            std::streamsize read = source->sgetn(buffer.data() + filled + got, static_cast<std::streamsize>(wanted - got));
+            if (read <= 0) {
+                final = true;
+                break;
+            }
+            got += static_cast<size_t>(read);
+        }
+        filled += got;
+
+        scanner.begin = buffer.data();
+        scanner.end = buffer.data() + filled;
+        scanner.final = final;
+        const char* resume = scanner.scan(staged);
+        if (resume == nullptr) {
+            in.setstate(std::ios::failbit);
+            return result;
+        }
+
+        size_t consumed = static_cast<size_t>(resume - buffer.data());
+        std::memmove(buffer.data(), resume, filled - consumed);
+        filled -= consumed;
+        scanner.base += consumed;
+    }
+
+    in.setstate(std::ios::eofbit);
+    group.append(staged);
+    return result;
+}
+
+template class BasicDominoTextParser<6>;
+template class BasicDominoTextParser<9>;
+template class BasicDominoTextParser<12>;
+template class BasicDominoTextParser<15>;
@@ -0,0 +1,88 @@
+#ifndef DOMINOTEXTPARSER_H
+#define DOMINOTEXTPARSER_H
+
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include "Domino.h"
+#include "DominoGroup.h"
+
+/**
+ * @enum DominoParseError
+ * @brief Причина ошибки разбора текста.
+ */
+enum class DominoParseError {
+    None,                /**< Ошибки нет. */
+    UnexpectedCharacter, /**< Символ, с которого не может начинаться или продолжаться домино. */
+    ValueOutOfRange,     /**< Значение стороны больше MaxPip. */
+    UnexpectedEnd,       /**< Текст закончился посреди домино. */
+    ReadFailed           /**< Поток не удалось прочитать. */
+};
+
+/**
+ * @struct DominoParseResult
+ * @brief Итог разбора: количество домино или место первой ошибки.
+ */
+struct DominoParseResult {
+    DominoParseError error = DominoParseError::None; /**< Причина ошибки. */
+    size_t tiles = 0;   /**< Количество разобранных домино (при ошибке — до места ошибки). */
+    size_t line = 0;    /**< Номер строки ошибки, начиная с 1 (0, если ошибки нет). */
+    size_t column = 0;  /**< Номер символа ошибки в строке, начиная с 1. */
+    size_t offset = 0;  /**< Смещение ошибки в байтах от начала текста. */
+
+    /**
+     * @brief Проверяет, что разбор прошел без ошибок.
+     * @return true, если ошибок нет.
+     */
+    bool ok() const noexcept {
+        return error == DominoParseError::None;
+    }
+};
+
+/**
+ * @class BasicDominoTextParser
+ * @brief Потоковый разбор домино из текста.
+ *
+ * Понимает две записи домино, которые можно смешивать: пары чисел "l r", разделенные
+ * пробельными символами, и формат вывода operator<< "(l|r)". Текст читается из потока
+ * кусками напрямую через streambuf, числа разбираются без локали и без исключений, поэтому
+ * разбор больших журналов ограничен в основном скоростью чтения.
+ *
+ * Заполнение транзакционное: домино добавляются в группу только если разобран весь текст.
+ * При ошибке группа не меняется, а результат содержит строку, столбец и смещение ошибки.
+ * Для набора 0..6 доступно имя DominoTextParser.
+ * @tparam MaxPip Наибольшее значение стороны.
+ */
+template<int MaxPip>
+class BasicDominoTextParser {
+public:
+    static constexpr size_t CHUNK_SIZE = 1 << 16; /**< Размер куска чтения из потока по умолчанию. */
+
+    /**
+     * @brief Разбирает текст и добавляет домино в конец группы.
+     * @param text Текст целиком.
+     * @param group Группа, в которую добавляются домино при успехе.
+     * @return Итог разбора.
+     */
+    static DominoParseResult parse(std::string_view text, BasicDominoGroup<MaxPip>& group);
+
+    /**
+     * @brief Разбирает поток до конца и добавляет домино в конец группы.
+     *
+     * Поток читается кусками по chunkSize байт; домино на границе кусков переносится в следующий.
+     * @param in Входной поток.
+     * @param group Группа, в которую добавляются домино при успехе.
+     * @param chunkSize Размер куска чтения в байтах.
+     * @return Итог разбора.
+     */
+    static DominoParseResult parse(std::istream& in, BasicDominoGroup<MaxPip>& group, size_t chunkSize = CHUNK_SIZE);
+};
+
+extern template class BasicDominoTextParser<6>;
+extern template class BasicDominoTextParser<9>;
+extern template class BasicDominoTextParser<12>;
+extern template class BasicDominoTextParser<15>;
+
+using DominoTextParser = BasicDominoTextParser<6>; /**< Разбор классических домино 0..6. */
+
+#endif
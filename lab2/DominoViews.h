@@ -0,0 +1,55 @@
+#ifndef DOMINOVIEWS_H
+#define DOMINOVIEWS_H
+
+#include <ranges>
+#include "Domino.h"
+
+/**
+ * @struct DominoViews
+ * @brief Ленивые представления для диапазонов домино.
+ *
+ * Каждая функция возвращает адаптер std::views::filter, который применяется к любому диапазону
+ * домино (BasicDominoGroup, std::span, другому представлению) через оператор |. Адаптеры
+ * объединяются в цепочки и не выделяют память: отбор выполняется при обходе результата.
+ * Пример: group | DominoViews::withPip(6) | DominoViews::pipSumBetween(8, 12).
+ *
+ * В отличие от BasicDominoGroup::getSubGroup исходная группа не изменяется. Представление
+ * ссылается на массив группы, поэтому изменение группы во время обхода делает его недействительным.
+ */
+struct DominoViews {
+    /**
+     * @brief Домино, у которых одна из сторон равна value.
+     * @param value Значение стороны.
+     * @return Адаптер представления.
+     */
+    static auto withPip(int value) {
+        return std::views::filter([value](const auto& d) {
+            return d.getLeft() == value || d.getRight() == value;
+        });
+    }
+
+    /**
+     * @brief Дубли — домино с равными сторонами.
+     * @return Адаптер представления.
+     */
+    static auto doubles() {
+        return std::views::filter([](const auto& d) {
+            return d.getLeft() == d.getRight();
+        });
+    }
+
+    /**
+     * @brief Домино с суммой сторон в отрезке [low, high].
+     * @param low Наименьшая сумма.
+     * @param high Наибольшая сумма.
+     * @return Адаптер представления.
+     */
+    static auto pipSumBetween(int low, int high) {
+        return std::views::filter([low, high](const auto& d) {
+            int sum = d.getLeft() + d.getRight();
+            return sum >= low && sum <= high;
+        });
+    }
+};
+
+#endif
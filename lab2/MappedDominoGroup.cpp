@@ -0,0 +1,145 @@
+#include "MappedDominoGroup.h"
+#include "DominoTables.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /**
+     * @brief Отображает файл в память только для чтения.
+     * @param path Путь к файлу.
+     * @param size Сюда записывается размер файла.
+     * @return Начало отображения (nullptr для пустого файла).
+     */
+    const char* mapFile(const std::string& path, size_t& size) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("Cannot open domino file: " + path);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        size = content.size();
+        char* copy = new char[size];
+        std::copy(content.begin(), content.end(), copy);
+        return copy;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open domino file: " + path);
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read domino file: " + path);
+        }
+        size = static_cast<size_t>(info.st_size);
+        void* data = size == 0 ? nullptr : ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) throw std::runtime_error("Cannot map domino file: " + path);
+        if (data != nullptr) ::madvise(data, size, MADV_SEQUENTIAL);
+        return static_cast<const char*>(data);
+#endif
+    }
+
+    void unmapFile(const char* data, size_t size) noexcept {
+#ifdef _WIN32
+        (void) size;
+        delete[] data;
+#else
+        if (data != nullptr) ::munmap(const_cast<char*>(data), size);
+#endif
+    }
+}
+
+template<int MaxPip>
+BasicMappedDominoGroup<MaxPip>::BasicMappedDominoGroup(const std::string& path)
+        : mapping(nullptr), mappingSize(0), codeData(nullptr), count(0) {
+    mapping = mapFile(path, mappingSize);
+    try {
+        if (mappingSize < DominoFileHeader::SIZE) {
+            throw std::runtime_error("Unexpected end of domino file");
+        }
+        DominoFileHeader header = DominoFileHeader::read(mapping);
+        if (header.maxPip != MaxPip) {
+            throw std::runtime_error("Domino file holds a different pip range");
+        }
+        if (header.encoding != DominoEncoding::Codes) {
+            throw std::runtime_error("Only code-encoded domino files can be mapped");
+        }
+        if (header.count > mappingSize - DominoFileHeader::SIZE) {
+            throw std::runtime_error("Unexpected end of domino file");
+        }
+        codeData = reinterpret_cast<const std::uint8_t*>(mapping + DominoFileHeader::SIZE);
+        count = static_cast<size_t>(header.count);
+
+        std::uint8_t highest = 0;
+        for (size_t i = 0; i < count; i++) {
+            highest = std::max(highest, codeData[i]);
+        }
+        if (count > 0 && highest >= BasicDominoTables<MaxPip>::ORDERED_COUNT) {
+            throw std::runtime_error("Invalid domino code in file");
+        }
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+template<int MaxPip>
+BasicMappedDominoGroup<MaxPip>::~BasicMappedDominoGroup() {
+    unmap();
+}
+
+template<int MaxPip>
+void BasicMappedDominoGroup<MaxPip>::unmap() noexcept {
+    unmapFile(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    codeData = nullptr;
+    count = 0;
+}
+
+template<int MaxPip>
+BasicMappedDominoGroup<MaxPip>::BasicMappedDominoGroup(BasicMappedDominoGroup&& other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)), mappingSize(std::exchange(other.mappingSize, 0)),
+          codeData(std::exchange(other.codeData, nullptr)), count(std::exchange(other.count, 0)) {}
+
+template<int MaxPip>
+BasicMappedDominoGroup<MaxPip>& BasicMappedDominoGroup<MaxPip>::operator=(BasicMappedDominoGroup&& other) noexcept {
+    if (this == &other) return *this;
+    unmap();
+    mapping = std::exchange(other.mapping, nullptr);
+    mappingSize = std::exchange(other.mappingSize, 0);
+    codeData = std::exchange(other.codeData, nullptr);
+    count = std::exchange(other.count, 0);
+    return *this;
+}
+
+template<int MaxPip>
+BasicDomino<MaxPip> BasicMappedDominoGroup<MaxPip>::operator[](size_t index) const {
+    if (index >= count) {
+        throw std::out_of_range("Invalid index");
+    }
+    return Tile::fromCode(codeData[index]);
+}
+
+template<int MaxPip>
+BasicDominoGroup<MaxPip> BasicMappedDominoGroup<MaxPip>::toGroup() const {
+    BasicDominoGroup<MaxPip> group;
+    group.reserve(count);
+    for (std::uint8_t code : codes()) {
+        group += Tile::fromCode(code);
+    }
+    return group;
+}
+
+template class BasicMappedDominoGroup<6>;
+template class BasicMappedDominoGroup<9>;
+template class BasicMappedDominoGroup<12>;
+template class BasicMappedDominoGroup<15>;
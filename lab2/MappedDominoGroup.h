@@ -0,0 +1,124 @@
+#ifndef MAPPEDDOMINOGROUP_H
+#define MAPPEDDOMINOGROUP_H
+
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string>
+#include "Domino.h"
+#include "DominoGroup.h"
+
+/**
+ * @class BasicMappedDominoGroup
+ * @brief Группа домино из двоичного файла, отображенного в память, только для чтения.
+ *
+ * Файл, записанный BasicDominoGroup::save в формате DominoEncoding::Codes, не копируется в
+ * кучу: домино декодируются из отображенных байтов при обращении. Поэтому большие архивы
+ * можно просматривать и фильтровать (например, mapped.tiles() | DominoViews::withPip(6)),
+ * не загружая их целиком. Коды проверяются один раз при открытии файла.
+ * @tparam MaxPip Наибольшее значение стороны (должно совпадать с записанным в файле).
+ */
+template<int MaxPip>
+class BasicMappedDominoGroup {
+public:
+    using Tile = BasicDomino<MaxPip>; /**< Тип домино группы. */
+
+private:
+    const char* mapping;            /**< Начало отображенного файла. */
+    size_t mappingSize;             /**< Размер отображения в байтах. */
+    const std::uint8_t* codeData;   /**< Коды домино сразу после заголовка. */
+    size_t count;                   /**< Количество домино в файле. */
+
+    /**
+     * @brief Освобождает отображение.
+     */
+    void unmap() noexcept;
+
+    /**
+     * @brief Преобразует код из файла в домино.
+     */
+    struct Decode {
+        Tile operator()(std::uint8_t code) const noexcept {
+            return Tile::fromCode(code);
+        }
+    };
+
+public:
+    /**
+     * @brief Отображает файл группы в память.
+     * @param path Путь к файлу.
+     * @throws std::runtime_error Если файл не открывается, поврежден, закодирован как
+     * DominoEncoding::Histogram или записан для другого диапазона значений.
+     */
+    explicit BasicMappedDominoGroup(const std::string& path);
+
+    /**
+     * @brief Деструктор, освобождающий отображение.
+     */
+    ~BasicMappedDominoGroup();
+
+    BasicMappedDominoGroup(const BasicMappedDominoGroup&) = delete;
+    BasicMappedDominoGroup& operator=(const BasicMappedDominoGroup&) = delete;
+
+    /**
+     * @brief Конструктор перемещения: забирает отображение, other становится пустой.
+     * @param other Перемещаемая группа.
+     */
+    BasicMappedDominoGroup(BasicMappedDominoGroup&& other) noexcept;
+
+    /**
+     * @brief Оператор перемещающего присваивания.
+     * @param other Перемещаемая группа.
+     * @return Ссылка на текущий объект.
+     */
+    BasicMappedDominoGroup& operator=(BasicMappedDominoGroup&& other) noexcept;
+
+    /**
+     * @brief Возвращает количество домино в файле.
+     * @return Количество домино.
+     */
+    size_t size() const noexcept {
+        return count;
+    }
+
+    /**
+     * @brief Возвращает домино по индексу.
+     * @param index Индекс домино.
+     * @return Декодированное домино.
+     * @throws std::out_of_range Если индекс выходит за пределы допустимого диапазона.
+     */
+    Tile operator[](size_t index) const;
+
+    /**
+     * @brief Возвращает коды домино (left * PIPS + right) прямо из отображения.
+     * @return Представление байтов файла без копирования.
+     */
+    std::span<const std::uint8_t> codes() const noexcept {
+        return {codeData, count};
+    }
+
+    /**
+     * @brief Возвращает ленивое представление домино файла.
+     *
+     * Представление с произвольным доступом; к нему применяются адаптеры DominoViews и std::views.
+     * @return Представление, декодирующее домино при обходе.
+     */
+    auto tiles() const noexcept {
+        return codes() | std::views::transform(Decode{});
+    }
+
+    /**
+     * @brief Копирует домино файла в обычную группу.
+     * @return Группа с теми же домино в том же порядке.
+     */
+    BasicDominoGroup<MaxPip> toGroup() const;
+};
+
+extern template class BasicMappedDominoGroup<6>;
+extern template class BasicMappedDominoGroup<9>;
+extern template class BasicMappedDominoGroup<12>;
+extern template class BasicMappedDominoGroup<15>;
+
+using MappedDominoGroup = BasicMappedDominoGroup<6>; /**< Отображенная группа классических домино 0..6. */
+
+#endif
@@ -0,0 +1,111 @@
+#include "bench_allocations.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> totalBytes{0}; /**< Сколько байт выделено через operator new. */
+
+    /**
+     * @brief Выделяет память с учетом в totalBytes.
+     * @param size Размер блока.
+     * @param alignment Выравнивание блока; 0 — выравнивание malloc.
+     * @return Указатель на блок или nullptr при нехватке памяти.
+     */
+    void* allocate(std::size_t size, std::size_t alignment) noexcept {
+        totalBytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0) size = 1;
+        if (alignment == 0) return std::malloc(size);
+        // aligned_alloc требует размер, кратный выравниванию
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+        if (void* p = allocate(size, alignment)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+std::size_t allocatedBytes() noexcept {
+    return totalBytes.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    return allocateOrThrow(size, 0);
+}
+
+void* operator new[](std::size_t size) {
+    return allocateOrThrow(size, 0);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
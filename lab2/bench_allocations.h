@@ -0,0 +1,16 @@
+#ifndef BENCH_ALLOCATIONS_H
+#define BENCH_ALLOCATIONS_H
+
+#include <cstddef>
+
+/**
+ * @brief Возвращает, сколько байт выделено через глобальные operator new с начала работы.
+ *
+ * Счет ведут замены всех форм operator new/delete (обычных, массивов, nothrow и выровненных)
+ * из bench_allocations.cpp. Они вынесены в отдельную единицу трансляции, чтобы компилятор
+ * не встраивал их в код бенчмарков.
+ * @return Суммарный объем выделенной памяти в байтах.
+ */
+std::size_t allocatedBytes() noexcept;
+
+#endif //BENCH_ALLOCATIONS_H
@@ -0,0 +1,347 @@
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include "bench_allocations.h"
+#include "Domino.h"
+#include "DominoGroup.h"
+#include "DominoTextParser.h"
+#include "ConcurrentBoneyard.h"
+#include "DominoViews.h"
+#include "DominoHandEnumerator.h"
+
+namespace {
+    /**
+     * @brief Задает размеры групп от одного полного набора до 10M домино.
+     */
+    void groupSizes(benchmark::internal::Benchmark* bench) {
+        bench->RangeMultiplier(8)->Range(28, 10'000'000)->Unit(benchmark::kMicrosecond);
+    }
+
+    /**
+     * @brief Записывает пропускную способность (домино/с) и объем выделенной памяти на итерацию.
+     * @param state Состояние бенчмарка.
+     * @param tiles Количество домино, обработанных за одну итерацию.
+     * @param bytesBefore Значение allocatedBytes() до начала замера.
+     */
+    void report(benchmark::State& state, size_t tiles, size_t bytesBefore) {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tiles));
+        state.counters["bytes_allocated"] = benchmark::Counter(
+                static_cast<double>(allocatedBytes() - bytesBefore) / static_cast<double>(state.iterations()));
+    }
+
+    DominoGroup fullSetOfSize(size_t size) {
+        return DominoGroup::generateFullSet(static_cast<int>(std::max<size_t>(1, size / 28)));
+    }
+}
+
+static void BM_GenerateFullSet(benchmark::State& state) {
+    size_t bytes = allocatedBytes();
+    size_t tiles = 0;
+    for (auto _ : state) {
+        DominoGroup group = fullSetOfSize(state.range(0));
+        tiles = group.size();
+        benchmark::DoNotOptimize(group);
+    }
+    report(state, tiles, bytes);
+}
+BENCHMARK(BM_GenerateFullSet)->Apply(groupSizes);
+
+static void BM_CreateRandomGroup(benchmark::State& state) {
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+        benchmark::DoNotOptimize(group);
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_CreateRandomGroup)->Apply(groupSizes);
+
+static void BM_AppendGrowth(benchmark::State& state) {
+    Domino tile(3, 4);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        DominoGroup group;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            group += tile;
+        }
+        benchmark::DoNotOptimize(group);
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_AppendGrowth)->Apply(groupSizes);
+
+static void BM_GetDomino(benchmark::State& state) {
+    // В полном наборе (6|6) стоит последним — худший случай поиска
+    DominoGroup group = fullSetOfSize(state.range(0));
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(group.getDomino(6, 6));
+        group += Domino(6, 6);
+    }
+    report(state, 1, bytes);
+}
+BENCHMARK(BM_GetDomino)->Apply(groupSizes);
+
+static void BM_GetRandomDomino(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    DominoRng gen(1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        group += group.getRandomDomino(gen);
+    }
+    report(state, 1, bytes);
+}
+BENCHMARK(BM_GetRandomDomino)->Apply(groupSizes);
+
+static void BM_GetSubGroup(benchmark::State& state) {
+    DominoGroup source = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        state.PauseTiming();
+        DominoGroup group = source;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(group.getSubGroup(3));
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_GetSubGroup)->Apply(groupSizes);
+
+static void BM_CountPlayable(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    int end = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(group.countPlayable(end, (end + 3) % 7));
+        end = (end + 1) % 7;
+    }
+    report(state, 1, bytes);
+}
+BENCHMARK(BM_CountPlayable)->Apply(groupSizes);
+
+static void BM_UnseenTiles(benchmark::State& state) {
+    const DominoGroup fullSet = DominoGroup::generateFullSet();
+    DominoGroup hand = DominoGroup::createRandomGroup(7, 1);
+    DominoGroup played = DominoGroup::createRandomGroup(state.range(0), 2);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        auto unseen = fullSet.tileMask() & ~hand.tileMask() & ~played.tileMask();
+        benchmark::DoNotOptimize(unseen);
+        benchmark::DoNotOptimize(hand.isSubsetOf(played));
+    }
+    report(state, 1, bytes);
+}
+BENCHMARK(BM_UnseenTiles)->Apply(groupSizes);
+
+// Перебор двух ходов вглубь: в каждом узле рука копируется
+static void BM_SearchCopy(benchmark::State& state) {
+    DominoGroup hand = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        for (size_t i = 0; i < hand.size(); i++) {
+            DominoGroup child = hand;
+            child.getByIndex(static_cast<int>(i));
+            for (size_t j = 0; j < child.size(); j++) {
+                DominoGroup grandchild = child;
+                grandchild.getByIndex(static_cast<int>(j));
+                benchmark::DoNotOptimize(grandchild.hash());
+            }
+        }
+    }
+    report(state, hand.size() * (hand.size() - 1), bytes);
+}
+BENCHMARK(BM_SearchCopy)->Arg(7)->Arg(28);
+
+// Тот же перебор на одной руке через takeByIndex и restore
+static void BM_SearchTakeRestore(benchmark::State& state) {
+    DominoGroup hand = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        for (size_t i = 0; i < hand.size(); i++) {
+            auto move = hand.takeByIndex(i);
+            for (size_t j = 0; j < hand.size(); j++) {
+                auto reply = hand.takeByIndex(j);
+                benchmark::DoNotOptimize(hand.hash());
+                hand.restore(reply);
+            }
+            hand.restore(move);
+        }
+    }
+    report(state, hand.size() * (hand.size() - 1), bytes);
+}
+BENCHMARK(BM_SearchTakeRestore)->Arg(7)->Arg(28);
+
+// Создание, заполнение и уничтожение руки: обычная группа растет в куче, встроенная — нет
+template<typename Hand>
+static void BM_HandLifecycle(benchmark::State& state) {
+    DominoGroup set = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        Hand hand;
+        for (const Domino& domino : set) hand += domino;
+        benchmark::DoNotOptimize(hand.hash());
+    }
+    report(state, set.size(), bytes);
+}
+BENCHMARK_TEMPLATE(BM_HandLifecycle, DominoGroup)->Arg(7)->Arg(28);
+BENCHMARK_TEMPLATE(BM_HandLifecycle, InlineDominoGroup<>)->Arg(7)->Arg(28);
+
+static void BM_Statistics(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        // Пустое изменение: замеряется пересчет индекса полным проходом по массиву
+        group.updateTiles([](std::span<Domino>) {}, static_cast<unsigned>(state.range(1)));
+        benchmark::DoNotOptimize(group.statistics());
+    }
+    report(state, state.range(0), bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * state.range(0) * sizeof(Domino)));
+}
+BENCHMARK(BM_Statistics)->ArgsProduct({{28, 4096, 262144, 10'000'000, 100'000'000}, {1, 0}})->Unit(benchmark::kMicrosecond);
+
+static void BM_ViewPipeline(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        auto heavy = group | DominoViews::withPip(3) | DominoViews::pipSumBetween(6, 9);
+        benchmark::DoNotOptimize(std::ranges::distance(heavy));
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_ViewPipeline)->Apply(groupSizes);
+
+static void BM_SortDominoes(benchmark::State& state) {
+    DominoGroup source = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        state.PauseTiming();
+        DominoGroup group = source;
+        state.ResumeTiming();
+        group.sortDominoes();
+        benchmark::DoNotOptimize(group);
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_SortDominoes)->Apply(groupSizes);
+
+static void BM_StreamOutput(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        std::ostringstream out;
+        out << group;
+        benchmark::DoNotOptimize(out);
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_StreamOutput)->Apply(groupSizes);
+
+static void BM_FormatText(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    std::string buffer(group.formattedSize(), '\0');
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(group.format(buffer.data(), buffer.size()));
+        benchmark::ClobberMemory();
+    }
+    report(state, state.range(0), bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+BENCHMARK(BM_FormatText)->Apply(groupSizes);
+
+static void BM_StreamInput(benchmark::State& state) {
+    DominoGroup source = DominoGroup::createRandomGroup(state.range(0), 1);
+    std::ostringstream text;
+    text << source.size();
+    for (size_t i = 0; i < source.size(); i++) {
+        text << ' ' << static_cast<int>(source[i].getLeft()) << ' ' << static_cast<int>(source[i].getRight());
+    }
+    const std::string input = text.str();
+
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        std::istringstream in(input);
+        DominoGroup group;
+        in >> group;
+        benchmark::DoNotOptimize(group);
+    }
+    report(state, state.range(0), bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_StreamInput)->Apply(groupSizes);
+
+static void BM_TextParser(benchmark::State& state) {
+    DominoGroup source = DominoGroup::createRandomGroup(state.range(0), 1);
+    std::ostringstream text;
+    text << source;
+    const std::string input = text.str();
+
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        std::istringstream in(input);
+        DominoGroup group;
+        benchmark::DoNotOptimize(DominoTextParser::parse(in, group));
+        benchmark::DoNotOptimize(group);
+    }
+    report(state, state.range(0), bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_TextParser)->Apply(groupSizes);
+
+static void BM_BinarySave(benchmark::State& state) {
+    DominoGroup group = DominoGroup::createRandomGroup(state.range(0), 1);
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        std::ostringstream out(std::ios::binary);
+        group.save(out);
+        benchmark::DoNotOptimize(out);
+    }
+    report(state, state.range(0), bytes);
+}
+BENCHMARK(BM_BinarySave)->Apply(groupSizes);
+
+static void BM_BinaryLoad(benchmark::State& state) {
+    std::ostringstream out(std::ios::binary);
+    DominoGroup::createRandomGroup(state.range(0), 1).save(out);
+    const std::string input = out.str();
+
+    size_t bytes = allocatedBytes();
+    for (auto _ : state) {
+        std::istringstream in(input, std::ios::binary);
+        benchmark::DoNotOptimize(DominoGroup::load(in));
+    }
+    report(state, state.range(0), bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_BinaryLoad)->Apply(groupSizes);
+
+// Все руки из 7 домино полного набора с дешевой оценкой: количество дублей
+static void BM_EnumerateHands(benchmark::State& state) {
+    DominoHandEnumerator hands(7);
+    constexpr DominoHandEnumerator::Mask doubles = 0b1010010001000010000010000001;
+    struct Count {
+        std::uint64_t total = 0;
+        void operator()(DominoHandEnumerator::Mask hand) { total += std::popcount(hand & doubles); }
+    };
+    for (auto _ : state) {
+        std::uint64_t total = 0;
+        for (const Count& part : hands.forEachParallel(Count{}, static_cast<unsigned>(state.range(0)))) {
+            total += part.total;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(hands.size()));
+}
+BENCHMARK(BM_EnumerateHands)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ConcurrentDraw(benchmark::State& state) {
+    static ConcurrentBoneyard boneyard(4);
+    DominoRng gen(static_cast<std::uint64_t>(state.thread_index()));
+    for (auto _ : state) {
+        auto tile = boneyard.draw(gen);
+        benchmark::DoNotOptimize(tile);
+        if (tile) boneyard.returnTile(*tile);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentDraw)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,6 +1,22 @@
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include "Domino.h"
 #include "DominoGroup.h"
+#include "DominoViews.h"
+#include "DominoHistogram.h"
+#include "DominoTables.h"
+#include "DominoChain.h"
+#include "DominoSimulation.h"
+#include "MappedDominoGroup.h"
+#include "DominoTextParser.h"
+#include "ConcurrentBoneyard.h"
+#include "DominoInstrumentation.h"
+#include "DominoHandEnumerator.h"
 
 TEST(DominoTest, DefaultConstructor) {
     Domino d;
@@ -49,6 +65,21 @@ TEST(DominoTest, OutputOperator) {
     EXPECT_EQ(out.str(), "(3|6)") << "Expected output is (3|6), but got: " << out.str();
 }
 
+TEST(DominoTest, CanonicalCodeAndHash) {
+    for (unsigned index = 0; index < Domino::TILE_COUNT; index++) {
+        Domino d = Domino::fromCanonicalCode(index);
+        EXPECT_LE(d.getLeft(), d.getRight());
+        EXPECT_EQ(d.canonicalCode(), index);
+        EXPECT_EQ((~d).canonicalCode(), index);
+    }
+    static_assert(Domino15::fromCanonicalCode(135) == Domino15(15, 15));
+    static_assert(Domino(6, 2).canonicalCode() == Domino(2, 6).canonicalCode());
+
+    std::unordered_set<Domino> seen{Domino(3, 5), Domino(5, 3), Domino(1, 1)};
+    EXPECT_EQ(seen.size(), 2);
+    EXPECT_TRUE(seen.contains(Domino(5, 3)));
+}
+
 TEST(DominoTest, InputOperator) {
     Domino d;
     std::stringstream input("4 2");
@@ -57,11 +88,83 @@ TEST(DominoTest, InputOperator) {
     EXPECT_EQ(d.getRight(), 2) << "Expected right value to be 2, but got: " << d.getRight();
 }
 
+TEST(DominoTest, PrintPicture) {
+    std::stringstream out;
+    Domino(3, 0).print(out);
+    EXPECT_EQ(out.str(),
+              "| o     |\n"
+              "|   o   |\n"
+              "|     o |\n"
+              "|-------|\n"
+              "|       |\n"
+              "|       |\n"
+              "|       |\n"
+              "\n");
+}
+
+TEST(DominoTest, ConstantExpressions) {
+    constexpr Domino d(2, 5);
+    static_assert(d.getLeft() == 2 && d.getRight() == 5);
+    static_assert((~d).getLeft() == 5);
+    static_assert(d == Domino(5, 2));
+    static_assert(Domino::fromCode(Domino(4, 1).code()).getLeft() == 4);
+    static_assert(DominoTables::fullSet[27] == Domino(6, 6));
+    static_assert(DominoTables::canonicalIndex[Domino(6, 3).code()] == DominoTables::canonical(3, 6));
+    static_assert(DominoTables::pipSum[Domino(6, 5).code()] == 11);
+
+    Domino unchecked(Domino::unchecked, 1, 3);
+    EXPECT_EQ(unchecked.getRight(), 3);
+    for (size_t i = 0; i < DominoTables::TILE_COUNT; i++) {
+        const Domino& tile = DominoTables::fullSet[i];
+        EXPECT_EQ(DominoTables::canonicalIndex[tile.code()], i);
+        EXPECT_EQ(DominoTables::canonicalIndex[(~tile).code()], i);
+        EXPECT_EQ(DominoTables::tilesWithPip[tile.getLeft()][tile.getRight()], i);
+        EXPECT_TRUE(DominoTables::pipMask[tile.code()] & (1u << tile.getRight()));
+    }
+}
+
 TEST(DominoGroupTest, CreateRandomGroup) {
     DominoGroup group = DominoGroup::createRandomGroup(5);
     EXPECT_EQ(group.size(), 5);
 }
 
+TEST(DominoGroupTest, CreateRandomGroupIsReproducible) {
+    DominoGroup single = DominoGroup::createRandomGroup(200000, 42, 1);
+    DominoGroup parallel = DominoGroup::createRandomGroup(200000, 42, 4);
+    DominoGroup other = DominoGroup::createRandomGroup(200000, 43, 1);
+
+    ASSERT_EQ(single.size(), 200000);
+    ASSERT_EQ(parallel.size(), 200000);
+    bool differs = false;
+    for (size_t i = 0; i < single.size(); i++) {
+        ASSERT_EQ(single[i].getLeft(), parallel[i].getLeft());
+        ASSERT_EQ(single[i].getRight(), parallel[i].getRight());
+        differs |= single[i].getLeft() != other[i].getLeft() || single[i].getRight() != other[i].getRight();
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(DominoGroupTest, RandomDominoCoversAllOutcomes) {
+    DominoRng gen(7);
+    int seen[7][7] = {};
+    for (int i = 0; i < 49000; i++) {
+        Domino d = Domino::generateRandomDomino(gen);
+        ASSERT_LE(d.getLeft(), 6);
+        ASSERT_LE(d.getRight(), 6);
+        ++seen[d.getLeft()][d.getRight()];
+    }
+    for (auto& row : seen) {
+        for (int hits : row) {
+            EXPECT_GT(hits, 800);
+            EXPECT_LT(hits, 1200);
+        }
+    }
+
+    std::mt19937 standard(1);
+    Domino d = Domino::generateRandomDomino(standard);
+    EXPECT_LE(d.getLeft(), 6);
+}
+
 TEST(DominoGroupTest, GenerateFullSet) {
     DominoGroup fullSet = DominoGroup::generateFullSet();
 
@@ -89,6 +192,73 @@ TEST(DominoGroupTest, GetRandomDomino) {
     DominoGroup group = DominoGroup::createRandomGroup(5);
     Domino d = group.getRandomDomino();
     EXPECT_EQ(group.size(), 4);
+    EXPECT_LE(d.getLeft(), 6);
+}
+
+TEST(DominoGroupTest, DrainWithSeededRandomDomino) {
+    DominoGroup group = DominoGroup::generateFullSet();
+    DominoRng gen(2024);
+    DominoGroup drawn;
+    while (group.size() > 0) {
+        drawn += group.getRandomDomino(gen);
+    }
+    EXPECT_THROW(group.getRandomDomino(gen), std::runtime_error);
+
+    ASSERT_EQ(drawn.size(), 28);
+    for (size_t i = 0; i < drawn.size(); i++) {
+        for (size_t j = i + 1; j < drawn.size(); j++) {
+            EXPECT_FALSE(drawn[i] == drawn[j]);
+        }
+    }
+}
+
+TEST(DominoGroupTest, NarrowGeneratorStaysUniform) {
+    std::mt19937 gen(11);
+    bool wide = false;
+    for (int i = 0; i < 64; i++) {
+        wide |= DominoRng::bounded(gen, std::uint64_t{1} << 40) >= (std::uint64_t{1} << 32);
+    }
+    EXPECT_TRUE(wide);
+
+    const DominoGroup fullSet = DominoGroup::generateFullSet();
+    std::unordered_map<unsigned, int> picked;
+    for (int i = 0; i < 2800; i++) {
+        DominoGroup group = fullSet;
+        ++picked[group.getRandomDomino(gen).code()];
+    }
+    ASSERT_EQ(picked.size(), 28u);
+    for (const auto& [code, hits] : picked) {
+        EXPECT_GT(hits, 50);
+        EXPECT_LT(hits, 150);
+    }
+
+    auto deal = DominoGroup::deal(4, 7, gen);
+    DominoGroup all;
+    for (const DominoGroup& hand : deal.hands) {
+        all.append(hand.tiles());
+    }
+    EXPECT_TRUE(all.sameTiles(fullSet));
+}
+
+TEST(DominoGroupTest, DealHands) {
+    DominoRng gen(5);
+    DominoDeal dealt = DominoGroup::deal(4, 6, gen);
+
+    ASSERT_EQ(dealt.hands.size(), 4);
+    EXPECT_EQ(dealt.boneyard.size(), 4);
+    DominoGroup all = dealt.boneyard;
+    for (const DominoGroup& hand : dealt.hands) {
+        EXPECT_EQ(hand.size(), 6);
+        for (size_t i = 0; i < hand.size(); i++) all += hand[i];
+    }
+    EXPECT_EQ(all.size(), 28);
+    for (size_t i = 0; i < all.size(); i++) {
+        for (size_t j = i + 1; j < all.size(); j++) {
+            EXPECT_FALSE(all[i] == all[j]);
+        }
+    }
+
+    EXPECT_THROW(DominoGroup::deal(5, 7), std::invalid_argument);
 }
 
 TEST(DominoGroupTest, GetSpecificDomino) {
@@ -129,6 +299,41 @@ TEST(DominoGroupTest, SortDominoes) {
     EXPECT_EQ(group[2].getRight(), 6);
 }
 
+TEST(DominoGroupTest, SortDominoesStableWithKeys) {
+    DominoGroup group{Domino(4, 1), Domino(2, 3), Domino(0, 0), Domino(1, 4), Domino(3, 2), Domino(5, 0)};
+
+    group.sortDominoes();
+    EXPECT_TRUE(group[0] == Domino(0, 0));
+    EXPECT_EQ(group[1].getLeft(), 4);
+    EXPECT_EQ(group[2].getLeft(), 2);
+    EXPECT_EQ(group[3].getLeft(), 1);
+    EXPECT_EQ(group[4].getLeft(), 3);
+    EXPECT_EQ(group[5].getLeft(), 5);
+
+    group.sortDominoes({.byMaxSide = true, .byOrientation = true, .descending = true});
+    EXPECT_EQ(group[0].getLeft(), 5);
+    EXPECT_EQ(group[1].getLeft(), 4);
+    EXPECT_EQ(group[2].getLeft(), 1);
+    EXPECT_EQ(group[3].getLeft(), 3);
+    EXPECT_EQ(group[4].getLeft(), 2);
+    EXPECT_TRUE(group[5] == Domino(0, 0));
+}
+
+TEST(DominoGroupTest, SortDominoesParallelMatchesSequential) {
+    DominoGroup sequential = DominoGroup::createRandomGroup(300000);
+    DominoGroup parallel;
+    parallel = sequential;
+
+    sequential.sortDominoes({.byMaxSide = true});
+    parallel.sortDominoes({.byMaxSide = true, .threads = 4});
+
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (size_t i = 0; i < sequential.size(); i++) {
+        ASSERT_EQ(parallel[i].getLeft(), sequential[i].getLeft());
+        ASSERT_EQ(parallel[i].getRight(), sequential[i].getRight());
+    }
+}
+
 TEST(DominoGroupTest, GetSubGroup) {
     DominoGroup group;
     group += Domino(5, 6);
@@ -143,6 +348,66 @@ TEST(DominoGroupTest, GetSubGroup) {
     EXPECT_EQ(group.size(), 2);
 }
 
+TEST(DominoGroupTest, GetSubGroupKeepsOrder) {
+    DominoGroup group{Domino(1, 2), Domino(3, 4), Domino(2, 5), Domino(6, 6), Domino(0, 2)};
+
+    DominoGroup subgroup = group.getSubGroup(2);
+
+    ASSERT_EQ(subgroup.size(), 3);
+    EXPECT_TRUE(subgroup[0] == Domino(1, 2));
+    EXPECT_TRUE(subgroup[1] == Domino(2, 5));
+    EXPECT_TRUE(subgroup[2] == Domino(0, 2));
+    ASSERT_EQ(group.size(), 2);
+    EXPECT_TRUE(group[0] == Domino(3, 4));
+    EXPECT_TRUE(group[1] == Domino(6, 6));
+}
+
+TEST(DominoGroupTest, ExtractIfAndEraseIf) {
+    DominoGroup group = DominoGroup::generateFullSet(2);
+
+    DominoGroup doubles = group.extractIf([](const Domino& d) { return d.getLeft() == d.getRight(); });
+    EXPECT_EQ(doubles.size(), 14);
+    EXPECT_EQ(doubles.getCapacity(), 14);
+    EXPECT_EQ(group.size(), 42);
+
+    size_t removed = group.eraseIf([](const Domino& d) { return d.getLeft() + d.getRight() > 6; });
+    EXPECT_EQ(removed, 18);
+    EXPECT_EQ(group.size(), 24);
+    for (size_t i = 0; i < group.size(); i++) {
+        EXPECT_LE(group[i].getLeft() + group[i].getRight(), 6);
+    }
+}
+
+TEST(DominoGroupTest, ExtractIfAndEraseIfWithThrowingPredicate) {
+    const DominoGroup original = DominoGroup::generateFullSet();
+    auto throwingAfter = [](int calls) {
+        return [calls](const Domino& d) mutable {
+            if (--calls < 0) throw std::runtime_error("predicate failed");
+            return d.getLeft() == d.getRight();
+        };
+    };
+
+    DominoGroup group = original;
+    EXPECT_THROW(group.extractIf(throwingAfter(20)), std::runtime_error);
+    ASSERT_EQ(group.size(), original.size());
+    for (size_t i = 0; i < group.size(); i++) {
+        EXPECT_EQ(group[i].code(), original[i].code());
+    }
+    EXPECT_EQ(group.countOf(3, 3), 1u);
+
+    EXPECT_THROW(group.eraseIf(throwingAfter(20)), std::runtime_error);
+    DominoGroup expected = original;
+    size_t examined = 0;
+    expected.eraseIf([&examined](const Domino& d) { return examined++ < 20 && d.getLeft() == d.getRight(); });
+    ASSERT_EQ(group.size(), expected.size());
+    for (size_t i = 0; i < group.size(); i++) {
+        EXPECT_EQ(group[i].code(), expected[i].code());
+    }
+    EXPECT_EQ(group.countOf(0, 0), 0u);
+    EXPECT_EQ(group.countOf(6, 6), 1u);
+    EXPECT_EQ(group.countOf(6, 5), 1u);
+}
+
 TEST(DominoGroupTest, AssignmentOperator) {
     DominoGroup group1 = DominoGroup::createRandomGroup(3);
     DominoGroup group2;
@@ -152,6 +417,158 @@ TEST(DominoGroupTest, AssignmentOperator) {
     EXPECT_EQ(group1[0].getLeft(), group2[0].getLeft());
 }
 
+TEST(DominoGroupTest, CopyAndMoveSemantics) {
+    DominoGroup original = DominoGroup::generateFullSet();
+    DominoGroup copy(original);
+    EXPECT_EQ(copy.size(), 28);
+    copy.getDomino(0, 0);
+    EXPECT_EQ(original.size(), 28);
+
+    DominoGroup moved(std::move(copy));
+    EXPECT_EQ(moved.size(), 27);
+    EXPECT_EQ(copy.size(), 0);
+    EXPECT_EQ(copy.getCapacity(), 0);
+
+    DominoGroup target{Domino(1, 1)};
+    target = std::move(moved);
+    EXPECT_EQ(target.size(), 27);
+    EXPECT_TRUE(target[0] == Domino(0, 1));
+
+    std::vector<DominoGroup> hands(3, original);
+    hands.push_back(std::move(target));
+    hands.resize(64);
+    EXPECT_EQ(hands[0].size(), 28);
+    EXPECT_EQ(hands[3].size(), 27);
+    // Встроенная группа, переданная как DominoGroup&&, копирует домино и может бросить исключение
+    EXPECT_FALSE(std::is_nothrow_move_constructible_v<DominoGroup>);
+    EXPECT_FALSE(std::is_nothrow_move_assignable_v<DominoGroup>);
+}
+
+TEST(DominoGroupTest, ReserveAndShrinkToFit) {
+    DominoGroup group;
+    group.reserve(100);
+    EXPECT_EQ(group.getCapacity(), 100);
+    group += Domino(2, 2);
+    group += Domino(3, 4);
+    group.shrinkToFit();
+    EXPECT_EQ(group.getCapacity(), 2);
+    EXPECT_TRUE(group[1] == Domino(3, 4));
+
+    DominoGroup larger = DominoGroup::generateFullSet();
+    larger = group;
+    EXPECT_EQ(larger.size(), 2);
+    EXPECT_EQ(larger.getCapacity(), 28);
+
+    EXPECT_THROW(group.reserve(DominoGroup::maxSize() + 1), std::length_error);
+    EXPECT_THROW(group.reserve(std::numeric_limits<size_t>::max()), std::length_error);
+    EXPECT_EQ(group.getCapacity(), 2);
+    EXPECT_EQ(group.size(), 2);
+}
+
+TEST(DominoGroupTest, MemoryResource) {
+    char arena[1024];
+    std::pmr::monotonic_buffer_resource pool(arena, sizeof(arena), std::pmr::null_memory_resource());
+
+    DominoGroup hand(&pool);
+    for (int i = 0; i <= 6; i++) hand += Domino(i, 6 - i);
+    EXPECT_EQ(hand.getResource(), &pool);
+    EXPECT_EQ(hand.size(), 7);
+
+    DominoGroup copy(hand, &pool);
+    DominoGroup sub = copy.getSubGroup(3);
+    EXPECT_EQ(sub.getResource(), &pool);
+    EXPECT_EQ(sub.size(), 1);
+    EXPECT_EQ(copy.size(), 6);
+}
+
+TEST(DominoGroupTest, InlineStorage) {
+    // Любое выделение из null_memory_resource бросает исключение
+    InlineDominoGroup<7> hand(std::pmr::null_memory_resource());
+    for (int i = 0; i <= 6; i++) hand += Domino(i, 6 - i);
+    EXPECT_EQ(hand.getCapacity(), 7);
+    EXPECT_TRUE(hand.getDomino(3, 3) == Domino(3, 3));
+    EXPECT_EQ(hand.countPlayable(0, 0), 2);
+
+    InlineDominoGroup<7> copy(hand);
+    EXPECT_TRUE(copy.sameTiles(hand));
+    DominoGroup plain(std::move(copy));
+    EXPECT_EQ(plain.size(), 6);
+    EXPECT_EQ(copy.size(), 0);
+    EXPECT_EQ(copy.getCapacity(), 7);
+
+    InlineDominoGroup<4> small{Domino(6, 6), Domino(1, 2)};
+    small.append(DominoGroup::generateFullSet());
+    EXPECT_EQ(small.size(), 30);
+    EXPECT_GT(small.getCapacity(), 4);
+    small.sortDominoes();
+    EXPECT_TRUE(small[29] == Domino(6, 6));
+    while (small.size() > 3) small.removeLast();
+    small.shrinkToFit();
+    EXPECT_EQ(small.getCapacity(), 4);
+    EXPECT_TRUE(small[2] == Domino(0, 2));
+    small.sortDominoes();
+    EXPECT_TRUE(small[0] == Domino(0, 0));
+
+    swap(small, plain);
+    EXPECT_EQ(small.size(), 6);
+    EXPECT_EQ(plain.size(), 3);
+    EXPECT_EQ(small.getCapacity(), 6);
+    EXPECT_TRUE(small.sameTiles(hand));
+
+    // Большой встроенный буфер сортируется подсчетом, домино остаются во встроенном буфере
+    InlineDominoGroup<200> large;
+    large.append(DominoGroup::createRandomGroup(190, 4).tiles());
+    DominoGroup expected(large);
+    large.sortDominoes({.descending = true});
+    expected.sortDominoes({.descending = true});
+    EXPECT_EQ(large.getCapacity(), 200);
+    EXPECT_TRUE(std::ranges::equal(large, expected, [](const Domino& a, const Domino& b) { return a.code() == b.code(); }));
+}
+
+TEST(DominoGroupTest, InlineStorageMovesWithoutAllocation) {
+    InlineDominoGroup<7> hand(std::pmr::null_memory_resource());
+    hand = DominoGroup{Domino(5, 5), Domino(0, 1), Domino(3, 2)};
+    EXPECT_EQ(hand.getCapacity(), 7);
+    EXPECT_EQ(hand.getResource(), std::pmr::null_memory_resource());
+    hand.sortDominoes();
+    EXPECT_TRUE(hand[0] == Domino(0, 1));
+    EXPECT_TRUE(hand[2] == Domino(5, 5));
+
+    DominoGroup plain{Domino(6, 6)};
+    plain.reserve(64);
+    hand = std::move(plain);
+    EXPECT_EQ(hand.size(), 1);
+    EXPECT_EQ(hand.getCapacity(), 7);
+    EXPECT_EQ(plain.size(), 0);
+    EXPECT_EQ(plain.getCapacity(), 0);
+
+    InlineDominoGroup<7> other(std::pmr::null_memory_resource());
+    other += Domino(1, 1);
+    other += Domino(2, 2);
+    swap(hand, other);
+    EXPECT_EQ(hand.size(), 2);
+    EXPECT_TRUE(other[0] == Domino(6, 6));
+    InlineDominoGroup<7> moved(std::move(hand));
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_EQ(hand.size(), 0);
+
+    EXPECT_TRUE(std::is_nothrow_move_constructible_v<InlineDominoGroup<7>>);
+    EXPECT_TRUE(std::is_nothrow_move_assignable_v<InlineDominoGroup<7>>);
+    EXPECT_FALSE((std::is_nothrow_constructible_v<DominoGroup, InlineDominoGroup<7>&&>));
+    DominoGroup heap(std::move(moved));
+    EXPECT_EQ(heap.size(), 2);
+    EXPECT_EQ(moved.size(), 0);
+
+    // Перемещение через ссылку на базовый класс бросает bad_alloc, а не вызывает std::terminate
+    other.sortDominoes();
+    DominoGroup& sliced = other;
+    EXPECT_THROW(DominoGroup fromSliced(std::move(sliced)), std::bad_alloc);
+    DominoGroup target(std::pmr::null_memory_resource());
+    EXPECT_THROW(target = std::move(sliced), std::bad_alloc);
+    EXPECT_EQ(other.size(), 1);
+    EXPECT_EQ(target.size(), 0);
+}
+
 TEST(DominoGroupTest, OutputOperator) {
     DominoGroup group;
     group += Domino(1, 2);
@@ -163,6 +580,180 @@ TEST(DominoGroupTest, OutputOperator) {
     EXPECT_EQ(out.str(), "(1|2) (3|4) ");
 }
 
+TEST(DominoGroupTest, BulkFormatMatchesPerTile) {
+    DominoGroup group = DominoGroup::createRandomGroup(30000, 5);
+    std::stringstream expected;
+    for (const Domino& d : group) {
+        expected << d << " ";
+    }
+    std::stringstream out;
+    out << group;
+    EXPECT_EQ(out.str(), expected.str());
+    EXPECT_EQ(group.format(), expected.str());
+    EXPECT_EQ(group.formattedSize(), expected.str().size());
+
+    DominoGroup15 wide{Domino15(15, 9), Domino15(10, 0), Domino15(3, 12)};
+    std::stringstream wideOut;
+    wideOut << wide;
+    EXPECT_EQ(wideOut.str(), "(15|9) (10|0) (3|12) ");
+    char small[8];
+    EXPECT_EQ(wide.format(small, sizeof(small)), wideOut.str().size());
+    std::string buffer(wide.formattedSize(), '\0');
+    EXPECT_EQ(wide.format(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_EQ(buffer, wideOut.str());
+}
+
+TEST(DominoGroupTest, WriteTextToDescriptor) {
+    DominoGroup group = DominoGroup::createRandomGroup(20000, 6);
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    group.writeText(fileno(file));
+
+    std::rewind(file);
+    std::string written(group.formattedSize() + 1, '\0');
+    written.resize(std::fread(written.data(), 1, written.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(written, group.format());
+    EXPECT_THROW(group.writeText(-1), std::runtime_error);
+}
+
+TEST(DominoGroupTest, SetAlgebra) {
+    DominoGroup hand{Domino(6, 5), Domino(0, 0), Domino(3, 1)};
+    DominoGroup played{Domino(1, 3), Domino(4, 4)};
+    DominoGroup unseen = DominoGroup::generateFullSet().setDifference(hand).setDifference(played);
+    EXPECT_EQ(unseen.size(), 24);
+    EXPECT_EQ(unseen.countOf(5, 6), 0);
+    EXPECT_EQ(unseen.countOf(2, 5), 1);
+    EXPECT_TRUE((unseen.tileMask() & hand.tileMask()).none());
+
+    EXPECT_TRUE(played.isSubsetOf(DominoGroup::generateFullSet()));
+    EXPECT_FALSE(hand.isSubsetOf(played));
+    EXPECT_TRUE(hand.setIntersection(played).sameTiles(DominoGroup{Domino(1, 3)}));
+    EXPECT_TRUE(hand.sameTiles(DominoGroup{Domino(1, 3), Domino(5, 6), Domino(0, 0)}));
+    EXPECT_FALSE(hand.sameTiles(played));
+
+    DominoGroup doubled = DominoGroup::generateFullSet(2);
+    DominoGroup once = doubled.setIntersection(DominoGroup::generateFullSet());
+    EXPECT_EQ(once.size(), 28);
+    EXPECT_EQ(doubled.setDifference(once).size(), 28);
+    EXPECT_EQ(hand.setUnion(played).size(), 4);
+    EXPECT_EQ(hand.setUnion(played).tileMask(), hand.tileMask() | played.tileMask());
+}
+
+TEST(DominoGroupTest, HashIsOrderIndependentAndIncremental) {
+    DominoGroup a{Domino(1, 2), Domino(4, 4), Domino(0, 6)};
+    DominoGroup b{Domino(6, 0), Domino(2, 1), Domino(4, 4)};
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_EQ(DominoGroup().hash(), 0u);
+
+    std::uint64_t before = a.hash();
+    a += Domino(4, 4);
+    EXPECT_NE(a.hash(), before);
+    a.getDomino(4, 4);
+    EXPECT_EQ(a.hash(), before);
+
+    // Хеш после изменений совпадает с пересчитанным заново
+    DominoGroup full = DominoGroup::generateFullSet(2);
+    full.getRandomDomino();
+    full.eraseIf([](const Domino& d) { return d.getLeft() == 3; });
+    DominoGroup copy;
+    for (const Domino& d : full) {
+        copy += d;
+    }
+    EXPECT_EQ(full.hash(), copy.hash());
+    full.setDomino(0, Domino(6, 6));
+    copy = DominoGroup();
+    copy.append(full.tiles());
+    EXPECT_EQ(full.hash(), copy.hash());
+
+    std::unordered_map<std::uint64_t, int> table{{b.hash(), 7}};
+    EXPECT_EQ(table.at(DominoGroup{Domino(4, 4), Domino(0, 6), Domino(1, 2)}.hash()), 7);
+    EXPECT_EQ(std::hash<DominoGroup>{}(b), static_cast<size_t>(b.hash()));
+}
+
+TEST(DominoGroupTest, TakeAndRestore) {
+    DominoGroup group = DominoGroup::createRandomGroup(40, 8);
+    const DominoGroup original = group;
+
+    std::vector<DominoGroup::Removal> removals;
+    removals.push_back(group.takeByIndex(3));
+    removals.push_back(group.takeByIndex(group.size() - 1));
+    removals.push_back(group.takeDomino(original[10].getRight(), original[10].getLeft()));
+    removals.push_back(group.takeByIndex(0));
+    group += Domino(5, 5);
+    EXPECT_EQ(group.size(), 37);
+    EXPECT_EQ(removals[0].domino.code(), original[3].code());
+    EXPECT_EQ(group[3].code(), original[39].code());
+
+    EXPECT_EQ(group.removeLast().code(), Domino(5, 5).code());
+    for (auto it = removals.rbegin(); it != removals.rend(); ++it) {
+        group.restore(*it);
+    }
+    ASSERT_EQ(group.size(), original.size());
+    EXPECT_TRUE(std::ranges::equal(group.tiles(), original.tiles(), {}, &Domino::code, &Domino::code));
+    EXPECT_EQ(group.hash(), original.hash());
+    EXPECT_EQ(group.getCapacity(), original.size());
+
+    EXPECT_THROW(group.takeByIndex(40), std::out_of_range);
+    DominoGroup single{Domino(1, 2)};
+    EXPECT_THROW(single.takeDomino(3, 3), std::invalid_argument);
+    single.removeLast();
+    EXPECT_THROW(single.removeLast(), std::runtime_error);
+}
+
+TEST(DominoGroupTest, StatisticsMatchScan) {
+    DominoGroup group = DominoGroup::createRandomGroup(2'500'000, 12, 2);
+    DominoStatistics expected;
+    expected.tiles = group.size();
+    for (const Domino& d : group) {
+        expected.totalPips += d.getLeft() + d.getRight();
+        expected.doubles += d.getLeft() == d.getRight();
+        ++expected.pipFaces[d.getLeft()];
+        ++expected.pipFaces[d.getRight()];
+        ++expected.pipSums[d.getLeft() + d.getRight()];
+    }
+
+    auto check = [&expected](const DominoStatistics& stats) {
+        EXPECT_EQ(stats.tiles, expected.tiles);
+        EXPECT_EQ(stats.totalPips, expected.totalPips);
+        EXPECT_EQ(stats.doubles, expected.doubles);
+        EXPECT_EQ(stats.pipFaces, expected.pipFaces);
+        EXPECT_EQ(stats.pipSums, expected.pipSums);
+    };
+    check(group.statistics());
+    group.updateTiles([](std::span<Domino> tiles) { std::ranges::reverse(tiles); }, 4);
+    check(group.statistics());
+
+    DominoGroup15 wide{Domino15(15, 15), Domino15(14, 3)};
+    auto stats = wide.statistics();
+    EXPECT_EQ(stats.totalPips, 47u);
+    EXPECT_EQ(stats.pipFaces[15], 2u);
+    EXPECT_EQ(stats.pipSums[30], 1u);
+    EXPECT_EQ(stats.doubles, 1u);
+}
+
+TEST(DominoGroupTest, PrintGroupLayouts) {
+    DominoGroup group{Domino(1, 2), Domino(6, 5), Domino(4, 4)};
+
+    std::stringstream vertical;
+    for (size_t i = 0; i < group.size(); i++) group[i].print(vertical);
+    vertical << "\n";
+    std::stringstream printed;
+    group.printGroup(printed);
+    EXPECT_EQ(printed.str(), vertical.str());
+    EXPECT_EQ(group.render(), vertical.str());
+
+    std::string rows = group.render(2);
+    EXPECT_EQ(rows.size(), group.renderedSize(2));
+    EXPECT_EQ(rows.substr(0, 20), "|       | | o   o |\n");
+    EXPECT_EQ(rows.substr(60, 20), "|-------| |-------|\n");
+    EXPECT_EQ(rows.substr(80, 20), "|   o   | | o   o |\n");
+    EXPECT_EQ(rows.substr(141, 10), "| o   o |\n");
+
+    char small[16];
+    EXPECT_EQ(group.render(small, sizeof(small)), group.renderedSize());
+}
+
 TEST(DominoGroupTest, InputOperator) {
     DominoGroup group;
     std::stringstream input("2 2 3 4 5");
@@ -175,6 +766,791 @@ TEST(DominoGroupTest, InputOperator) {
     EXPECT_EQ(group[1].getRight(), 5);
 }
 
+TEST(DominoGroupTest, InputOperatorIsTransactional) {
+    DominoGroup group{Domino(1, 1)};
+    std::stringstream truncated("3 2 3 4");
+    truncated >> group;
+    EXPECT_TRUE(truncated.fail());
+    ASSERT_EQ(group.size(), 1);
+    EXPECT_EQ(group[0], Domino(1, 1));
+
+    std::stringstream invalid("2 2 3 4 9");
+    EXPECT_THROW(invalid >> group, std::invalid_argument);
+    EXPECT_EQ(group.size(), 1);
+}
+
+TEST(DominoTextParserTest, ParsesBothFormats) {
+    DominoGroup group{Domino(6, 6)};
+    DominoParseResult result = DominoTextParser::parse("1 2\n(3|4) (0|6)\t5\n0 ", group);
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(result.tiles, 4);
+    ASSERT_EQ(group.size(), 5);
+    EXPECT_EQ(group[1].code(), Domino(1, 2).code());
+    EXPECT_EQ(group[3].code(), Domino(0, 6).code());
+    EXPECT_EQ(group[4].code(), Domino(5, 0).code());
+    EXPECT_EQ(group.countWithPip(6), 2);
+
+    std::stringstream out;
+    out << group;
+    DominoGroup reparsed;
+    EXPECT_TRUE(DominoTextParser::parse(out.str(), reparsed).ok());
+    EXPECT_TRUE(std::ranges::equal(reparsed, group, [](const Domino& a, const Domino& b) { return a.code() == b.code(); }));
+}
+
+TEST(DominoTextParserTest, ReportsErrorPosition) {
+    DominoGroup group{Domino(2, 2)};
+    DominoParseResult result = DominoTextParser::parse("1 2\n3 4\n  (5|7)", group);
+    EXPECT_EQ(result.error, DominoParseError::ValueOutOfRange);
+    EXPECT_EQ(result.line, 3);
+    EXPECT_EQ(result.column, 6);
+    EXPECT_EQ(result.offset, 13);
+    EXPECT_EQ(result.tiles, 2);
+    EXPECT_EQ(group.size(), 1);
+
+    EXPECT_EQ(DominoTextParser::parse("1 2 x", group).error, DominoParseError::UnexpectedCharacter);
+    EXPECT_EQ(DominoTextParser::parse("1 2 3", group).error, DominoParseError::UnexpectedEnd);
+    EXPECT_EQ(DominoTextParser::parse("(1|2", group).error, DominoParseError::UnexpectedEnd);
+    EXPECT_EQ(group.size(), 1);
+}
+
+TEST(DominoTextParserTest, StreamsAcrossChunks) {
+    DominoGroup source = DominoGroup::createRandomGroup(20000, 8);
+    std::stringstream text;
+    for (size_t i = 0; i < source.size(); i++) {
+        if (i % 2) {
+            text << source[i] << (i % 7 == 0 ? "\n" : " ");
+        } else {
+            text << static_cast<int>(source[i].getLeft()) << "\n " << static_cast<int>(source[i].getRight()) << ' ';
+        }
+    }
+    text << "\n0" << std::string(40, '0') << " 3 (2|";
+
+    DominoGroup group;
+    DominoParseResult result = DominoTextParser::parse(text, group, 16);
+    EXPECT_EQ(result.error, DominoParseError::UnexpectedEnd);
+    EXPECT_EQ(result.tiles, source.size() + 1);
+    EXPECT_EQ(group.size(), 0);
+
+    std::stringstream valid(text.str().substr(0, text.str().size() - 4));
+    result = DominoTextParser::parse(valid, group, 16);
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(group.size(), source.size() + 1);
+    EXPECT_TRUE(std::ranges::equal(group.tiles().first(source.size()), source,
+                                   [](const Domino& a, const Domino& b) { return a.code() == b.code(); }));
+    EXPECT_EQ(group[static_cast<int>(source.size())].code(), Domino(0, 3).code());
+}
+
+TEST(DominoTextParserTest, ShortReadsAreNotEndOfText) {
+    // Источник, отдающий не больше трех байт за чтение, как канал или сокет
+    struct TrickleBuffer : std::stringbuf {
+        using std::stringbuf::stringbuf;
+        std::streamsize xsgetn(char* s, std::streamsize n) override {
+            return std::stringbuf::xsgetn(s, std::min<std::streamsize>(n, 3));
+        }
+    };
+    TrickleBuffer buffer("(1|2) 3 4\n(5|6) 1");
+    std::istream in(&buffer);
+
+    DominoGroup group;
+    DominoParseResult result = DominoTextParser::parse(in, group, 16);
+    EXPECT_EQ(result.error, DominoParseError::UnexpectedEnd);
+    EXPECT_EQ(result.tiles, 3u);
+
+    TrickleBuffer valid("(1|2) 3 4\n(5|6) 1 0");
+    std::istream validIn(&valid);
+    ASSERT_TRUE(DominoTextParser::parse(validIn, group, 16).ok());
+    ASSERT_EQ(group.size(), 4);
+    EXPECT_EQ(group[3].code(), Domino(1, 0).code());
+}
+
+TEST(DominoInstrumentationTest, CountsGroupOperations) {
+    DominoInstrumentation::reset();
+    DominoGroup group;
+    for (int i = 0; i < 5; i++) {
+        group += Domino(static_cast<std::uint8_t>(i), 6);
+    }
+    group.getByIndex(1);
+    group.getDomino(6, 4);
+    std::thread([] {
+        DominoGroup::generateFullSet(2).sortDominoes();
+    }).join();
+
+    DominoInstrumentationSnapshot snapshot = DominoInstrumentation::snapshot();
+    std::string json = snapshot.toJson();
+    if constexpr (DominoInstrumentation::enabled) {
+        EXPECT_EQ(snapshot[DominoCounter::Allocations], 6u);
+        EXPECT_EQ(snapshot[DominoCounter::BytesCopied], (1 + 2 + 4) * sizeof(Domino));
+        EXPECT_EQ(snapshot[DominoCounter::ElementsShifted], 3u);
+        EXPECT_EQ(snapshot[DominoCounter::Comparisons], 4u);
+        EXPECT_EQ(snapshot[DominoOperation::Reserve].calls, 5u);
+        EXPECT_EQ(snapshot[DominoOperation::GetByIndex].calls, 1u);
+        EXPECT_EQ(snapshot[DominoOperation::SortDominoes].calls, 1u);
+        EXPECT_NE(json.find("\"enabled\":true"), std::string::npos);
+    } else {
+        EXPECT_EQ(snapshot[DominoCounter::Allocations], 0u);
+        EXPECT_EQ(snapshot[DominoOperation::Reserve].calls, 0u);
+        EXPECT_NE(json.find("\"enabled\":false"), std::string::npos);
+    }
+    EXPECT_NE(json.find("\"getByIndex\":{\"calls\":"), std::string::npos);
+
+    DominoInstrumentation::reset();
+    EXPECT_EQ(DominoInstrumentation::snapshot()[DominoCounter::Allocations], 0u);
+}
+
+TEST(ConcurrentBoneyardTest, DrawTryDrawAndReturn) {
+    ConcurrentBoneyard boneyard(2);
+    EXPECT_EQ(boneyard.size(), 56);
+
+    auto tile = boneyard.tryDraw(5, 2);
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->code(), Domino(5, 2).code());
+    EXPECT_TRUE(boneyard.tryDraw(2, 5).has_value());
+    EXPECT_FALSE(boneyard.tryDraw(2, 5).has_value());
+    EXPECT_EQ(boneyard.count(5, 2), 0);
+
+    boneyard.returnTile(Domino(2, 5));
+    EXPECT_EQ(boneyard.count(2, 5), 1);
+    boneyard.returnTile(Domino(5, 2));
+    EXPECT_THROW(boneyard.returnTile(Domino(5, 2)), std::invalid_argument);
+    EXPECT_THROW(boneyard.tryDraw(7, 0), std::invalid_argument);
+    EXPECT_THROW(boneyard.tryDraw(262, 0), std::invalid_argument);
+    EXPECT_THROW(boneyard.tryDraw(0, -1), std::invalid_argument);
+    EXPECT_EQ(boneyard.count(6, 0), 2);
+
+    DominoGroup drawn;
+    while (auto next = boneyard.draw()) {
+        drawn += *next;
+    }
+    EXPECT_EQ(boneyard.size(), 0);
+    EXPECT_TRUE(drawn.sameTiles(DominoGroup::generateFullSet(2)));
+    EXPECT_EQ(boneyard.toGroup().size(), 0);
+}
+
+TEST(ConcurrentBoneyardTest, ThreadsDrawEveryTileOnce) {
+    ConcurrentBoneyard boneyard(50);
+    constexpr size_t threads = 8;
+    std::vector<DominoGroup> hands(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&boneyard, &hand = hands[t], t] {
+            DominoRng gen(t);
+            // Часть домино возвращается и забирается снова
+            while (auto tile = boneyard.draw(gen)) {
+                if (gen() % 4 == 0) {
+                    boneyard.returnTile(*tile);
+                } else if (auto same = boneyard.tryDraw(tile->getRight(), tile->getLeft()); same && gen() % 2) {
+                    hand += *tile;
+                    hand += *same;
+                } else {
+                    if (same) boneyard.returnTile(*same);
+                    hand += *tile;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    DominoGroup all;
+    for (const DominoGroup& hand : hands) {
+        all.append(hand.tiles());
+    }
+    EXPECT_EQ(boneyard.size(), 0);
+    EXPECT_TRUE(all.sameTiles(DominoGroup::generateFullSet(50)));
+}
+
+TEST(ConcurrentBoneyardTest, NoSpuriousEmptyDraws) {
+    constexpr size_t threads = 4;
+    ConcurrentBoneyard boneyard(1);
+    // В базаре остается по домино на поток: тот, кто берет, видит хотя бы одно чужое
+    for (size_t i = threads; i < 28; i++) {
+        ASSERT_TRUE(boneyard.draw().has_value());
+    }
+    ASSERT_EQ(boneyard.size(), threads);
+
+    // Почти пустой базар: оставшиеся домино вытягиваются равновероятно
+    DominoRng gen(3);
+    std::unordered_map<unsigned, int> picked;
+    for (int i = 0; i < 4000; i++) {
+        auto tile = boneyard.draw(gen);
+        ASSERT_TRUE(tile.has_value());
+        ++picked[tile->code()];
+        boneyard.returnTile(*tile);
+    }
+    ASSERT_EQ(picked.size(), threads);
+    for (const auto& [code, hits] : picked) {
+        EXPECT_GT(hits, 850);
+        EXPECT_LT(hits, 1150);
+    }
+
+    std::atomic<size_t> empty{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&boneyard, &empty, t] {
+            DominoRng local(t);
+            for (int i = 0; i < 20000; i++) {
+                if (auto tile = boneyard.draw(local)) {
+                    boneyard.returnTile(*tile);
+                } else {
+                    empty.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(empty.load(), 0u);
+    EXPECT_EQ(boneyard.size(), threads);
+    EXPECT_EQ(boneyard.toGroup().size(), threads);
+}
+
+TEST(DominoHandEnumeratorTest, FullSetOrderAndUnrank) {
+    DominoHandEnumerator hands(7);
+    EXPECT_EQ(hands.size(), 1184040u);
+
+    std::uint64_t visited = 0;
+    DominoHandEnumerator::Mask previous = 0;
+    bool ordered = true;
+    hands.forEach([&](DominoHandEnumerator::Mask hand) {
+        ordered = ordered && hand > previous && std::popcount(hand) == 7 && hand < (1u << 28);
+        if (visited == 1000 || visited == hands.size() - 1) {
+            EXPECT_EQ(hands.unrank(visited), hand);
+        }
+        previous = hand;
+        ++visited;
+    });
+    EXPECT_EQ(visited, hands.size());
+    EXPECT_TRUE(ordered);
+    EXPECT_THROW(hands.unrank(hands.size()), std::out_of_range);
+
+    DominoGroup first = DominoHandEnumerator::toGroup(hands.unrank(0));
+    EXPECT_EQ(first.size(), 7);
+    EXPECT_TRUE(first[0] == Domino(0, 0));
+    EXPECT_TRUE(first[6] == Domino(0, 6));
+
+    InlineDominoGroup<7> hand(std::pmr::null_memory_resource());
+    DominoHandEnumerator::toGroup(previous, hand);
+    EXPECT_TRUE(hand[6] == Domino(6, 6));
+    EXPECT_THROW(DominoHandEnumerator(29), std::invalid_argument);
+}
+
+TEST(DominoHandEnumeratorTest, RemainderPoolAndThreads) {
+    DominoGroup mine{Domino(0, 0), Domino(2, 5), Domino(6, 6)};
+    DominoGroup unseen = DominoGroup::generateFullSet().setDifference(mine);
+    DominoHandEnumerator opponent(unseen, 7);
+    EXPECT_EQ(opponent.size(), 480700u); // C(25, 7)
+    EXPECT_EQ(opponent.unrank(0), DominoHandEnumerator::Mask(0b11111110));
+
+    std::uint64_t mineMask = unseen.tileMask().flip().to_ullong();
+    std::uint64_t sample = 0;
+    opponent.forEach(0, 100000, [&](DominoHandEnumerator::Mask hand) {
+        if ((hand & mineMask) == 0 && std::popcount(hand) == 7) ++sample;
+    });
+    EXPECT_EQ(sample, 100000u);
+    EXPECT_TRUE(DominoHandEnumerator::toGroup(opponent.unrank(480699)).isSubsetOf(unseen));
+
+    // Каждая из 5 оставшихся дублей входит в C(24, 6) рук
+    struct Doubles {
+        std::uint64_t hands = 0;
+        std::uint64_t doubles = 0;
+        void operator()(DominoHandEnumerator::Mask hand) {
+            ++hands;
+            doubles += std::popcount(hand & 0b1010010001000010000010000001ull);
+        }
+    };
+    for (unsigned threads : {1u, 4u}) {
+        Doubles total;
+        for (const Doubles& part : opponent.forEachParallel(Doubles{}, threads)) {
+            total.hands += part.hands;
+            total.doubles += part.doubles;
+        }
+        EXPECT_EQ(total.hands, opponent.size());
+        EXPECT_EQ(total.doubles, 5u * 134596u);
+    }
+
+    DominoGroup repeated{Domino(1, 2), Domino(2, 1)};
+    EXPECT_THROW(DominoHandEnumerator(repeated, 1), std::invalid_argument);
+}
+
+TEST(DominoGroupTest, PipIndexTracksMutations) {
+    DominoGroup group{Domino(1, 2), Domino(2, 2), Domino(5, 6)};
+    EXPECT_EQ(group.countWithPip(2), 2);
+    EXPECT_EQ(group.countOf(2, 1), 1);
+
+    group += Domino(2, 6);
+    EXPECT_EQ(group.countWithPip(6), 2);
+    group.getDomino(2, 2);
+    group.getByIndex(0);
+    EXPECT_EQ(group.countWithPip(2), 1);
+
+    DominoRng gen(5);
+    group.getRandomDomino(gen);
+    EXPECT_EQ(group.countOf(5, 6) + group.countOf(2, 6), 1);
+    EXPECT_EQ(group.countWithPip(6), 1);
+
+    group.setDomino(0, Domino(0, 0));
+    EXPECT_EQ(group.countOf(0, 0), 1);
+    EXPECT_EQ(group.countWithPip(6), 0);
+}
+
+TEST(DominoGroupTest, IndexedWritesKeepIndex) {
+    DominoGroup group{Domino(1, 2), Domino(3, 3), Domino(6, 1)};
+    group[0] = Domino(5, 5);
+    EXPECT_EQ(group[0].getLeft(), 5);
+    EXPECT_EQ(group.countOf(1, 2), 0);
+    EXPECT_EQ(group.countOf(5, 5), 1);
+
+    group[2].setRight(4);
+    EXPECT_TRUE(group[2] == Domino(6, 4));
+    EXPECT_EQ(group.countOf(6, 1), 0);
+    EXPECT_EQ(group.countOf(4, 6), 1);
+
+    group[1] = group[2];
+    EXPECT_EQ(group.countOf(3, 3), 0);
+    EXPECT_EQ(group.countOf(6, 4), 2);
+
+    std::istringstream in("0 2");
+    in >> group[1];
+    EXPECT_EQ(group.countOf(2, 0), 1);
+    EXPECT_EQ(group.countWithPip(6), 1);
+    EXPECT_THROW(group[3] = Domino(1, 1), std::out_of_range);
+    EXPECT_THROW(group[-1].getLeft(), std::out_of_range);
+}
+
+TEST(DominoGroupTest, IndexIsReadyAfterBulkChanges) {
+    // Константные запросы ничего не пересчитывают, поэтому их можно выполнять из нескольких потоков
+    const DominoGroup group = DominoGroup::createRandomGroup(50000, 3, 2);
+    size_t doubles = static_cast<size_t>(std::ranges::count_if(group, [](const Domino& d) { return d.getLeft() == d.getRight(); }));
+    std::vector<std::thread> readers;
+    std::vector<size_t> seen(4);
+    for (size_t t = 0; t < seen.size(); t++) {
+        readers.emplace_back([&group, &seen, t] {
+            for (int v = 0; v <= 6; v++) seen[t] += group.countOf(v, v);
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    for (size_t value : seen) EXPECT_EQ(value, doubles);
+
+    std::stringstream file;
+    group.save(file);
+    DominoGroup loaded = DominoGroup::load(file);
+    EXPECT_EQ(loaded.hash(), group.hash());
+    EXPECT_EQ(loaded.statistics().doubles, doubles);
+}
+
+TEST(DominoGroupTest, PlayableMatchesScan) {
+    DominoGroup group = DominoGroup::createRandomGroup(2000, 9);
+    DominoDeal dealt = DominoGroup::deal(2, 7);
+    DominoGroup moved = std::move(dealt.boneyard);
+    for (int a = 0; a <= 6; a++) {
+        for (int b = 0; b <= 6; b++) {
+            size_t expected = 0;
+            for (size_t i = 0; i < group.size(); i++) {
+                const Domino& d = std::as_const(group)[static_cast<int>(i)];
+                expected += d.getLeft() == a || d.getRight() == a || d.getLeft() == b || d.getRight() == b;
+            }
+            size_t visited = 0;
+            group.forEachPlayable(a, b, [&](const Domino& tile, size_t copies) {
+                EXPECT_LE(tile.getLeft(), tile.getRight());
+                visited += copies;
+            });
+            EXPECT_EQ(visited, expected);
+            EXPECT_EQ(group.countPlayable(a, b), expected);
+        }
+    }
+    EXPECT_EQ(moved.countWithPip(3) + dealt.hands[0].countWithPip(3) + dealt.hands[1].countWithPip(3), 7);
+    EXPECT_EQ(group.countPlayable(-1, 7), 0);
+}
+
+TEST(DominoGroupTest, RangeInterface) {
+    static_assert(std::ranges::contiguous_range<DominoGroup>);
+    DominoGroup group{Domino(1, 2), Domino(3, 3), Domino(6, 1)};
+
+    int pips = 0;
+    for (const Domino& d : group) pips += d.getLeft() + d.getRight();
+    EXPECT_EQ(pips, 16);
+    EXPECT_EQ(std::ranges::count_if(group, [](const Domino& d) { return d.getLeft() == 1 || d.getRight() == 1; }), 2);
+    EXPECT_EQ(group.tiles().size(), 3);
+    EXPECT_EQ(group.data(), &std::as_const(group)[0]);
+    EXPECT_TRUE(DominoGroup().empty());
+
+    EXPECT_EQ(group.countOf(3, 3), 1);
+    group.updateTiles([](std::span<Domino> tiles) { std::ranges::fill(tiles, Domino(4, 4)); });
+    EXPECT_EQ(group.countOf(3, 3), 0);
+    EXPECT_EQ(group.countOf(4, 4), 3);
+}
+
+TEST(DominoGroupTest, LazyViews) {
+    DominoGroup group = DominoGroup::generateFullSet(2);
+    auto sixes = group | DominoViews::withPip(6);
+    EXPECT_EQ(std::ranges::distance(sixes), 14);
+
+    auto heavyDoubles = group | DominoViews::doubles() | DominoViews::pipSumBetween(8, 12);
+    std::vector<Domino> collected(heavyDoubles.begin(), heavyDoubles.end());
+    ASSERT_EQ(collected.size(), 6);
+    EXPECT_EQ(collected.front(), Domino(4, 4));
+    EXPECT_EQ(collected.back(), Domino(6, 6));
+
+    auto fromSpan = group.tiles() | DominoViews::withPip(0) | std::views::take(3);
+    EXPECT_EQ(std::ranges::distance(fromSpan), 3);
+    EXPECT_EQ(group.size(), 56);
+}
+
+TEST(DominoGroupTest, BinaryRoundTrip) {
+    DominoGroup group = DominoGroup::createRandomGroup(100000, 21);
+    std::stringstream codes;
+    group.save(codes);
+    EXPECT_EQ(codes.str().size(), DominoFileHeader::SIZE + group.size());
+
+    DominoGroup loaded = DominoGroup::load(codes);
+    ASSERT_EQ(loaded.size(), group.size());
+    EXPECT_TRUE(std::ranges::equal(loaded, group, [](const Domino& a, const Domino& b) { return a.code() == b.code(); }));
+    EXPECT_EQ(loaded.countWithPip(4), group.countWithPip(4));
+
+    std::stringstream histogram;
+    group.save(histogram, DominoEncoding::Histogram);
+    EXPECT_EQ(histogram.str().size(), DominoFileHeader::SIZE + 28 * 8);
+    DominoGroup canonical = DominoGroup::load(histogram);
+    EXPECT_EQ(canonical.size(), group.size());
+    EXPECT_EQ(canonical.countOf(2, 5), group.countOf(5, 2));
+    EXPECT_LE(canonical[0].getLeft(), canonical[0].getRight());
+}
+
+TEST(DominoGroupTest, BinaryRejectsBadData) {
+    std::stringstream text("not a domino file");
+    EXPECT_THROW(DominoGroup::load(text), std::runtime_error);
+
+    std::stringstream nine;
+    DominoGroup9::generateFullSet().save(nine);
+    EXPECT_THROW(DominoGroup::load(nine), std::runtime_error);
+
+    std::stringstream truncated;
+    DominoGroup::generateFullSet().save(truncated);
+    std::string bytes = truncated.str();
+    std::stringstream shortInput(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(DominoGroup::load(shortInput), std::runtime_error);
+
+    bytes.back() = static_cast<char>(49);
+    std::stringstream corrupted(bytes);
+    EXPECT_THROW(DominoGroup::load(corrupted), std::runtime_error);
+}
+
+TEST(DominoGroupTest, BinaryRejectsOverflowingHistogram) {
+    std::stringstream empty;
+    DominoGroup().save(empty, DominoEncoding::Histogram);
+    std::string bytes = empty.str();
+    auto setCount = [&bytes](size_t index, std::uint64_t value) {
+        for (size_t b = 0; b < 8; b++) {
+            bytes[DominoFileHeader::SIZE + 8 * index + b] = static_cast<char>(value >> (8 * b));
+        }
+    };
+
+    // Суммы переполняются до 0, что совпадает с заявленным размером
+    setCount(0, (std::uint64_t(1) << 63) + 1);
+    setCount(1, (std::uint64_t(1) << 63) - 1);
+    std::stringstream wrapped(bytes);
+    EXPECT_THROW(DominoGroup::load(wrapped), std::runtime_error);
+
+    setCount(0, std::uint64_t(1) << 63);
+    setCount(1, std::uint64_t(1) << 63);
+    std::stringstream halves(bytes);
+    EXPECT_THROW(DominoGroup::load(halves), std::runtime_error);
+
+    // Согласованная гистограмма с размером, байты которого не помещаются в size_t
+    DominoFileHeader header = DominoFileHeader::read(bytes.data());
+    header.count = std::uint64_t(1) << 63;
+    header.write(bytes.data());
+    setCount(0, 0);
+    setCount(1, std::uint64_t(1) << 63);
+    std::stringstream huge(bytes);
+    EXPECT_THROW(DominoGroup::load(huge), std::runtime_error);
+}
+
+TEST(DominoGroupTest, MappedFile) {
+    std::string path = (std::filesystem::temp_directory_path() / "domino_mapped_test.bin").string();
+    DominoGroup group = DominoGroup::createRandomGroup(5000, 4);
+    {
+        std::ofstream file(path, std::ios::binary);
+        group.save(file);
+    }
+
+    MappedDominoGroup mapped(path);
+    ASSERT_EQ(mapped.size(), group.size());
+    EXPECT_EQ(mapped[17].code(), group[17].code());
+    EXPECT_THROW(mapped[5000], std::out_of_range);
+    EXPECT_EQ(std::ranges::distance(mapped.tiles() | DominoViews::withPip(6)),
+              std::ranges::distance(group | DominoViews::withPip(6)));
+    EXPECT_EQ(mapped.toGroup().countOf(3, 1), group.countOf(1, 3));
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        group.save(file, DominoEncoding::Histogram);
+    }
+    EXPECT_THROW(MappedDominoGroup{path}, std::runtime_error);
+    std::filesystem::remove(path);
+    EXPECT_THROW(MappedDominoGroup{path}, std::runtime_error);
+}
+
+TEST(DominoHistogramTest, FullSetAndCount) {
+    DominoHistogram set = DominoHistogram::generateFullSet(3);
+    EXPECT_EQ(set.size(), 84);
+    EXPECT_EQ(set.count(2, 5), 3);
+    EXPECT_EQ(set.count(5, 2), 3);
+    EXPECT_EQ(DominoHistogram::indexOf(0, 0), 0);
+    EXPECT_EQ(DominoHistogram::indexOf(6, 6), 27);
+}
+
+TEST(DominoHistogramTest, AddAndGetDomino) {
+    DominoHistogram group;
+    group += Domino(4, 5);
+    group += Domino(5, 4);
+
+    Domino d = group.getDomino(5, 4);
+    EXPECT_EQ(d.getLeft(), 5);
+    EXPECT_EQ(d.getRight(), 4);
+    EXPECT_EQ(group.size(), 1);
+    group.getDomino(4, 5);
+    EXPECT_THROW(group.getDomino(4, 5), std::invalid_argument);
+}
+
+TEST(DominoHistogramTest, GetSubGroup) {
+    DominoHistogram group = DominoHistogram::generateFullSet(2);
+    DominoHistogram subgroup = group.getSubGroup(1);
+
+    EXPECT_EQ(subgroup.size(), 14);
+    EXPECT_EQ(subgroup.count(1, 1), 2);
+    EXPECT_EQ(group.size(), 42);
+    EXPECT_EQ(group.count(1, 3), 0);
+}
+
+TEST(DominoHistogramTest, MatchesGroup) {
+    DominoGroup group{Domino(3, 2), Domino(1, 1), Domino(2, 3)};
+    DominoHistogram histogram(group);
+
+    std::stringstream out;
+    out << histogram;
+    EXPECT_EQ(out.str(), "(1|1) (2|3) (2|3) ");
+    EXPECT_EQ(histogram.toGroup().size(), 3);
+}
+
+TEST(DominoHistogramTest, SetAlgebra) {
+    DominoHistogram a{Domino(1, 2), Domino(2, 1), Domino(4, 4)};
+    DominoHistogram b{Domino(2, 1), Domino(0, 6)};
+
+    DominoHistogram both = a.setIntersection(b);
+    EXPECT_EQ(both.size(), 1);
+    EXPECT_EQ(both.count(1, 2), 1);
+    EXPECT_EQ(a.setUnion(b).size(), 4);
+    EXPECT_EQ(a.setDifference(b), (DominoHistogram{Domino(1, 2), Domino(4, 4)}));
+    EXPECT_TRUE(both.isSubsetOf(a));
+    EXPECT_FALSE(a.isSubsetOf(b));
+    EXPECT_EQ(a.tileMask().count(), 2);
+}
+
+TEST(DominoPipRangeTest, FullSetSizes) {
+    static_assert(BasicDominoTables<9>::TILE_COUNT == 55);
+    static_assert(BasicDominoTables<12>::TILE_COUNT == 91);
+    static_assert(BasicDominoTables<15>::TILE_COUNT == 136);
+    static_assert(BasicDominoTables<15>::fullSet[135] == Domino15(15, 15));
+
+    EXPECT_EQ(DominoGroup9::generateFullSet().size(), 55);
+    EXPECT_EQ(DominoGroup12::generateFullSet(2).size(), 182);
+    EXPECT_EQ(DominoHistogram15::generateFullSet().size(), 136);
+    EXPECT_EQ(DominoHistogram15::indexOf(15, 15), 135);
+}
+
+TEST(DominoPipRangeTest, ValidatesPerRange) {
+    EXPECT_NO_THROW(Domino9(9, 7));
+    EXPECT_THROW(Domino9(10, 0), std::invalid_argument);
+    EXPECT_NO_THROW(Domino15(15, 12));
+    EXPECT_THROW(Domino(7, 0), std::invalid_argument);
+
+    Domino12 d;
+    std::stringstream in("12 11 13 0");
+    in >> d;
+    EXPECT_EQ(d.getLeft(), 12);
+    EXPECT_THROW(in >> d, std::invalid_argument);
+}
+
+TEST(DominoPipRangeTest, GroupOperations) {
+    DominoGroup15 group = DominoGroup15::createRandomGroup(5000, 11);
+    for (size_t i = 0; i < group.size(); i++) {
+        ASSERT_LE(group[i].getLeft(), 15);
+        ASSERT_LE(group[i].getRight(), 15);
+    }
+
+    group.sortDominoes({.byMaxSide = true});
+    for (size_t i = 1; i < group.size(); i++) {
+        int prevSum = group[i - 1].getLeft() + group[i - 1].getRight();
+        int sum = group[i].getLeft() + group[i].getRight();
+        ASSERT_LE(prevSum, sum);
+    }
+
+    DominoGroup9 set = DominoGroup9::generateFullSet();
+    DominoGroup9 nines = set.getSubGroup(9);
+    EXPECT_EQ(nines.size(), 10);
+    EXPECT_EQ(set.size(), 45);
+    EXPECT_EQ(set.getDomino(8, 3), Domino9(3, 8));
+    EXPECT_THROW(set.getDomino(10, 3), std::invalid_argument);
+
+    DominoHistogram12 histogram(DominoGroup12::generateFullSet());
+    EXPECT_EQ(histogram.getSubGroup(12).size(), 13);
+}
+
+TEST(DominoPipRangeTest, PrintLargeValues) {
+    std::stringstream out;
+    Domino15(9, 13).print(out);
+    EXPECT_EQ(out.str(),
+              "| o o o |\n"
+              "| o o o |\n"
+              "| o o o |\n"
+              "|-------|\n"
+              "|       |\n"
+              "|  13   |\n"
+              "|       |\n"
+              "\n");
+}
+
+namespace {
+    bool isValidChain(const DominoGroup& chain, const DominoGroup& source) {
+        DominoHistogram available(source);
+        for (size_t i = 0; i < chain.size(); i++) {
+            if (i > 0 && chain[i - 1].getRight() != chain[i].getLeft()) return false;
+            if (available.count(chain[i].getLeft(), chain[i].getRight()) == 0) return false;
+            available.getDomino(chain[i].getLeft(), chain[i].getRight());
+        }
+        return true;
+    }
+
+    size_t bruteForceChain(DominoGroup& rest, int end) {
+        size_t best = 0;
+        for (size_t i = 0; i < rest.size(); i++) {
+            Domino d = rest[i];
+            int next = d.getLeft() == end ? d.getRight() : d.getRight() == end ? d.getLeft() : -1;
+            if (end != -1 && next == -1) continue;
+            rest.getByIndex(static_cast<int>(i));
+            if (end == -1) {
+                best = std::max(best, 1 + bruteForceChain(rest, d.getRight()));
+                best = std::max(best, 1 + bruteForceChain(rest, d.getLeft()));
+            } else {
+                best = std::max(best, 1 + bruteForceChain(rest, next));
+            }
+            rest += d;
+            rest.updateTiles([i](std::span<Domino> tiles) { std::rotate(tiles.begin() + i, tiles.end() - 1, tiles.end()); });
+        }
+        return best;
+    }
+}
+
+TEST(DominoChainTest, FullSetIsOneChain) {
+    DominoGroup set = DominoGroup::generateFullSet();
+    DominoGroup chain = DominoChain::longest(set);
+    EXPECT_EQ(chain.size(), 28);
+    EXPECT_TRUE(isValidChain(chain, set));
+
+    DominoGroup repeated = DominoGroup::generateFullSet(5);
+    DominoGroup longChain = DominoChain::longest(repeated, 3);
+    EXPECT_EQ(longChain.size(), 140);
+    EXPECT_EQ(longChain[0].getLeft(), 3);
+    EXPECT_TRUE(isValidChain(longChain, repeated));
+}
+
+TEST(DominoChainTest, SmallHands) {
+    DominoGroup hand{Domino(1, 2), Domino(3, 2), Domino(5, 6), Domino(3, 3)};
+    DominoGroup chain = DominoChain::longest(hand);
+    EXPECT_EQ(chain.size(), 3);
+    EXPECT_TRUE(isValidChain(chain, hand));
+
+    DominoGroup fromSix = DominoChain::longest(hand, 6);
+    ASSERT_EQ(fromSix.size(), 1);
+    EXPECT_EQ(fromSix[0].getLeft(), 6);
+    EXPECT_EQ(DominoChain::longest(hand, 0).size(), 0);
+    EXPECT_THROW(DominoChain::longest(hand, 7), std::invalid_argument);
+}
+
+TEST(DominoChainTest, MatchesBruteForce) {
+    DominoRng gen(11);
+    std::vector<DominoGroup> hands;
+    for (int round = 0; round < 40; round++) {
+        DominoGroup hand = DominoGroup::createRandomGroup(9, gen());
+        hands.push_back(hand);
+        DominoGroup chain = DominoChain::longest(hand);
+        EXPECT_TRUE(isValidChain(chain, hand));
+        EXPECT_EQ(chain.size(), bruteForceChain(hand, -1));
+    }
+
+    std::vector<DominoGroup> chains = DominoChain::longestBatch(hands, -1, 3);
+    ASSERT_EQ(chains.size(), hands.size());
+    for (size_t i = 0; i < hands.size(); i++) {
+        EXPECT_EQ(chains[i].size(), DominoChain::longest(hands[i]).size());
+    }
+}
+
+TEST(DominoSimulationTest, SingleGameAccounting) {
+    DominoSimulationConfig config;
+    config.players = 3;
+    config.rules = DominoRules::Draw;
+    DominoRng gen(9);
+
+    DominoSimulationStats stats = DominoSimulation::playGame(config, gen);
+    EXPECT_EQ(stats.games, 1);
+    size_t outcomes = stats.ties;
+    for (size_t wins : stats.wins) outcomes += wins;
+    EXPECT_EQ(outcomes, 1);
+    EXPECT_GE(stats.tilesPlayed, 1);
+    EXPECT_LE(stats.tilesPlayed, 28);
+}
+
+TEST(DominoSimulationTest, DeterministicAcrossThreads) {
+    DominoSimulationConfig config;
+    config.players = 4;
+    config.policies = {DominoSimulation::heaviestTile, DominoSimulation::randomMove,
+                       DominoSimulation::firstPlayable, DominoSimulation::randomMove};
+    config.seed = 77;
+
+    config.threads = 1;
+    DominoSimulationStats single = DominoSimulation::run(config, 3000);
+    config.threads = 4;
+    DominoSimulationStats parallel = DominoSimulation::run(config, 3000);
+
+    EXPECT_EQ(single.games, 3000);
+    EXPECT_EQ(single.wins, parallel.wins);
+    EXPECT_EQ(single.pipsLeft, parallel.pipsLeft);
+    EXPECT_EQ(single.tilesPlayed, parallel.tilesPlayed);
+    EXPECT_EQ(single.blocked, parallel.blocked);
+    EXPECT_EQ(single.ties, parallel.ties);
+
+    size_t outcomes = single.ties;
+    for (size_t p = 0; p < config.players; p++) outcomes += single.wins[p];
+    EXPECT_EQ(outcomes, 3000);
+    EXPECT_GT(single.averageLength(), 0.0);
+}
+
+TEST(DominoSimulationTest, InvalidConfig) {
+    DominoSimulationConfig config;
+    config.players = 5;
+    EXPECT_THROW(DominoSimulation::run(config, 1), std::invalid_argument);
+    config.players = 2;
+    config.policies = {DominoSimulation::firstPlayable};
+    EXPECT_THROW(DominoSimulation::run(config, 1), std::invalid_argument);
+}
+
+TEST(DominoSimulationTest, PolicyErrorsReachTheCaller) {
+    DominoSimulationConfig config;
+    config.players = 2;
+    config.threads = 4;
+    config.policies = {DominoSimulation::firstPlayable,
+                       [](const DominoTableView& view, DominoRng&) { return view.moves.size(); }};
+    EXPECT_THROW(DominoSimulation::run(config, 5000), std::out_of_range);
+
+    config.policies[1] = [](const DominoTableView&, DominoRng&) -> size_t {
+        throw std::runtime_error("policy failed");
+    };
+    EXPECT_THROW(DominoSimulation::run(config, 5000), std::runtime_error);
+}
+
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);